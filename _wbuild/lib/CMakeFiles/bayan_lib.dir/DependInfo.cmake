@@ -0,0 +1,39 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/lib/src/block_reader.cpp" "lib/CMakeFiles/bayan_lib.dir/src/block_reader.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/block_reader.cpp.o.d"
+  "/root/repo/lib/src/cancellation.cpp" "lib/CMakeFiles/bayan_lib.dir/src/cancellation.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/cancellation.cpp.o.d"
+  "/root/repo/lib/src/chunk_analyzer.cpp" "lib/CMakeFiles/bayan_lib.dir/src/chunk_analyzer.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/chunk_analyzer.cpp.o.d"
+  "/root/repo/lib/src/deduplicator.cpp" "lib/CMakeFiles/bayan_lib.dir/src/deduplicator.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/deduplicator.cpp.o.d"
+  "/root/repo/lib/src/digest_group_table.cpp" "lib/CMakeFiles/bayan_lib.dir/src/digest_group_table.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/digest_group_table.cpp.o.d"
+  "/root/repo/lib/src/directory_scanner.cpp" "lib/CMakeFiles/bayan_lib.dir/src/directory_scanner.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/directory_scanner.cpp.o.d"
+  "/root/repo/lib/src/duplicate_files_searcher.cpp" "lib/CMakeFiles/bayan_lib.dir/src/duplicate_files_searcher.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/duplicate_files_searcher.cpp.o.d"
+  "/root/repo/lib/src/duplicate_groups.cpp" "lib/CMakeFiles/bayan_lib.dir/src/duplicate_groups.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/duplicate_groups.cpp.o.d"
+  "/root/repo/lib/src/duplicate_index.cpp" "lib/CMakeFiles/bayan_lib.dir/src/duplicate_index.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/duplicate_index.cpp.o.d"
+  "/root/repo/lib/src/group_scheduler.cpp" "lib/CMakeFiles/bayan_lib.dir/src/group_scheduler.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/group_scheduler.cpp.o.d"
+  "/root/repo/lib/src/hashing.cpp" "lib/CMakeFiles/bayan_lib.dir/src/hashing.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/hashing.cpp.o.d"
+  "/root/repo/lib/src/io_throttle.cpp" "lib/CMakeFiles/bayan_lib.dir/src/io_throttle.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/io_throttle.cpp.o.d"
+  "/root/repo/lib/src/multi_buffer_md5.cpp" "lib/CMakeFiles/bayan_lib.dir/src/multi_buffer_md5.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/multi_buffer_md5.cpp.o.d"
+  "/root/repo/lib/src/path_store.cpp" "lib/CMakeFiles/bayan_lib.dir/src/path_store.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/path_store.cpp.o.d"
+  "/root/repo/lib/src/reference_index.cpp" "lib/CMakeFiles/bayan_lib.dir/src/reference_index.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/reference_index.cpp.o.d"
+  "/root/repo/lib/src/search_budget.cpp" "lib/CMakeFiles/bayan_lib.dir/src/search_budget.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/search_budget.cpp.o.d"
+  "/root/repo/lib/src/search_progress.cpp" "lib/CMakeFiles/bayan_lib.dir/src/search_progress.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/search_progress.cpp.o.d"
+  "/root/repo/lib/src/size_count_sketch.cpp" "lib/CMakeFiles/bayan_lib.dir/src/size_count_sketch.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/size_count_sketch.cpp.o.d"
+  "/root/repo/lib/src/tar_archive.cpp" "lib/CMakeFiles/bayan_lib.dir/src/tar_archive.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/tar_archive.cpp.o.d"
+  "/root/repo/lib/src/throttle_control_file.cpp" "lib/CMakeFiles/bayan_lib.dir/src/throttle_control_file.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/throttle_control_file.cpp.o.d"
+  "/root/repo/lib/src/tracing.cpp" "lib/CMakeFiles/bayan_lib.dir/src/tracing.cpp.o" "gcc" "lib/CMakeFiles/bayan_lib.dir/src/tracing.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,51 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bayan_lib.dir/src/block_reader.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/block_reader.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/cancellation.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/cancellation.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/chunk_analyzer.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/chunk_analyzer.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/deduplicator.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/deduplicator.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/digest_group_table.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/digest_group_table.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/directory_scanner.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/directory_scanner.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/duplicate_files_searcher.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/duplicate_files_searcher.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/duplicate_groups.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/duplicate_groups.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/duplicate_index.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/duplicate_index.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/group_scheduler.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/group_scheduler.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/hashing.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/hashing.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/io_throttle.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/io_throttle.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/multi_buffer_md5.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/multi_buffer_md5.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/path_store.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/path_store.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/reference_index.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/reference_index.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/search_budget.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/search_budget.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/search_progress.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/search_progress.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/size_count_sketch.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/size_count_sketch.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/tar_archive.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/tar_archive.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/throttle_control_file.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/throttle_control_file.cpp.o.d"
+  "CMakeFiles/bayan_lib.dir/src/tracing.cpp.o"
+  "CMakeFiles/bayan_lib.dir/src/tracing.cpp.o.d"
+  "libbayan_lib.pdb"
+  "libbayan_lib.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bayan_lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
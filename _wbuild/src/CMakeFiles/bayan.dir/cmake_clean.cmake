@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bayan.dir/main.cpp.o"
+  "CMakeFiles/bayan.dir/main.cpp.o.d"
+  "bayan"
+  "bayan.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bayan.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tests.dir/bayan_lib_tests.cpp.o"
+  "CMakeFiles/tests.dir/bayan_lib_tests.cpp.o.d"
+  "tests"
+  "tests.pdb"
+  "tests[1]_tests.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
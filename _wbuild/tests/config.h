@@ -0,0 +1,8 @@
+#pragma once
+
+#include <string>
+
+inline std::string get_test_project_root()
+{
+    return "/root/repo/tests";
+}
@@ -0,0 +1,45 @@
+add_test([=[Bayan.RecursiveTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.RecursiveTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.RecursiveTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.TopLevelTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.TopLevelTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.TopLevelTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.PathStoreTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.PathStoreTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.PathStoreTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.DigestGroupTableTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.DigestGroupTableTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.DigestGroupTableTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.BudgetTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.BudgetTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.BudgetTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.GroupSchedulerTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.GroupSchedulerTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.GroupSchedulerTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.DeduplicatorTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.DeduplicatorTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.DeduplicatorTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.AsyncTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.AsyncTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.AsyncTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.EngineSpecializationTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.EngineSpecializationTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.EngineSpecializationTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.BatchHashingTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.BatchHashingTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.BatchHashingTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.SmallFilesTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.SmallFilesTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.SmallFilesTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.ReferenceIndexTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.ReferenceIndexTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.ReferenceIndexTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.DuplicateIndexTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.DuplicateIndexTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.DuplicateIndexTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.MemoryLeanScanTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.MemoryLeanScanTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.MemoryLeanScanTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.FollowSymlinksTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.FollowSymlinksTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.FollowSymlinksTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.NativeWalkerTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.NativeWalkerTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.NativeWalkerTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.OverlappingRootsTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.OverlappingRootsTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.OverlappingRootsTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.TracingTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.TracingTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.TracingTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.ThrottleTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.ThrottleTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.ThrottleTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.SparseFilesTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.SparseFilesTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.SparseFilesTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.ChunkAnalysisTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.ChunkAnalysisTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.ChunkAnalysisTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[Bayan.TarArchiveTest]=]  /root/repo/_wbuild/tests/tests [==[--gtest_filter=Bayan.TarArchiveTest]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[Bayan.TarArchiveTest]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_wbuild/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  tests_TESTS Bayan.RecursiveTest Bayan.TopLevelTest Bayan.PathStoreTest Bayan.DigestGroupTableTest Bayan.BudgetTest Bayan.GroupSchedulerTest Bayan.DeduplicatorTest Bayan.AsyncTest Bayan.EngineSpecializationTest Bayan.BatchHashingTest Bayan.SmallFilesTest Bayan.ReferenceIndexTest Bayan.DuplicateIndexTest Bayan.MemoryLeanScanTest Bayan.FollowSymlinksTest Bayan.NativeWalkerTest Bayan.OverlappingRootsTest Bayan.TracingTest Bayan.ThrottleTest Bayan.SparseFilesTest Bayan.ChunkAnalysisTest Bayan.TarArchiveTest)
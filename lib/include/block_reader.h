@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace bayan
+{
+    /**
+     * @brief Way of reading file blocks.
+     */
+    enum class BlockReaderType
+    {
+        Posix,
+        Stream
+    };
+
+    /**
+     * @brief Result of searching for data, when only a hole follows the offset.
+     */
+    inline constexpr std::uintmax_t no_data_offset = UINTMAX_MAX;
+
+    /**
+     * @brief Reads file blocks with std::ifstream. Holes of sparse files aren't detected.
+     */
+    class StreamBlockReader final
+    {
+    public:
+        /**
+         * @brief Opens file for reading.
+         *
+         * @param file_path path to file.
+         */
+        explicit StreamBlockReader(const std::string& file_path);
+
+        /**
+         * @brief Reads next bytes of file.
+         *
+         * @param buffer destination buffer.
+         *
+         * @param size count of bytes to read.
+         *
+         * @return count of read bytes. It is less than requested at the end of file.
+         */
+        size_t read(char* buffer, size_t size);
+
+        /**
+         * @brief Skips next bytes of file without reading them.
+         *
+         * @param size count of bytes to skip.
+         */
+        void skip(std::uintmax_t size);
+
+        /**
+         * @brief Finds the first offset of data at or after the offset, so preceding bytes belong to a hole of a sparse file.
+         *
+         * @param offset offset in file.
+         *
+         * @return offset of data or @link no_data_offset @endlink, if only a hole follows.
+         */
+        [[nodiscard]] std::uintmax_t find_data(std::uintmax_t offset) const;
+
+        /**
+         * @brief Finds the first offset of a hole at or after the offset. End of file is treated as a hole.
+         *
+         * @param offset offset of data in file.
+         *
+         * @return offset of hole.
+         */
+        [[nodiscard]] std::uintmax_t find_hole(std::uintmax_t offset) const;
+
+        /**
+         * @brief Closes file.
+         */
+        void close() noexcept;
+
+        /**
+         * @brief Checks whether file is open.
+         */
+        [[nodiscard]] bool is_open() const noexcept;
+
+    private:
+        std::ifstream m_fs;
+    };
+
+    /**
+     * @brief Reads file blocks directly with POSIX file descriptor, bypassing stream buffering.
+     * Holes of sparse files are detected with lseek(SEEK_DATA/SEEK_HOLE), where supported.
+     */
+    class PosixBlockReader final
+    {
+    public:
+        /**
+         * @brief Opens file for sequential reading.
+         *
+         * @param file_path path to file.
+         */
+        explicit PosixBlockReader(const std::string& file_path);
+
+        PosixBlockReader(const PosixBlockReader&) = delete;
+
+        /**
+         * @brief PosixBlockReader move ctor.
+         */
+        PosixBlockReader(PosixBlockReader&& other) noexcept;
+
+        ~PosixBlockReader();
+
+        /**
+         * @brief Reads next bytes of file.
+         *
+         * @param buffer destination buffer.
+         *
+         * @param size count of bytes to read.
+         *
+         * @return count of read bytes. It is less than requested at the end of file.
+         */
+        size_t read(char* buffer, size_t size);
+
+        /**
+         * @brief Skips next bytes of file without reading them.
+         *
+         * @param size count of bytes to skip.
+         */
+        void skip(std::uintmax_t size);
+
+        /**
+         * @brief Finds the first offset of data at or after the offset, so preceding bytes belong to a hole of a sparse file.
+         *
+         * @param offset offset in file.
+         *
+         * @return offset of data or @link no_data_offset @endlink, if only a hole follows.
+         */
+        [[nodiscard]] std::uintmax_t find_data(std::uintmax_t offset) const;
+
+        /**
+         * @brief Finds the first offset of a hole at or after the offset. End of file is treated as a hole.
+         *
+         * @param offset offset of data in file.
+         *
+         * @return offset of hole.
+         */
+        [[nodiscard]] std::uintmax_t find_hole(std::uintmax_t offset) const;
+
+        /**
+         * @brief Closes file.
+         */
+        void close() noexcept;
+
+        /**
+         * @brief Checks whether file is open.
+         */
+        [[nodiscard]] bool is_open() const noexcept;
+
+        PosixBlockReader& operator =(const PosixBlockReader&) = delete;
+
+        /**
+         * @brief PosixBlockReader move assignment operator.
+         *
+         * @return reference to assigned instance.
+         */
+        PosixBlockReader& operator =(PosixBlockReader&& other) noexcept;
+
+    private:
+        int m_fd;
+        std::uintmax_t m_offset;
+    };
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+namespace bayan
+{
+    /**
+     * @brief Exception, thrown when an operation is stopped by a cancellation request.
+     */
+    class OperationCanceledError final : public std::runtime_error
+    {
+    public:
+        OperationCanceledError();
+    };
+
+    /**
+     * @brief Represents a token to observe cancellation requests of a @link CancellationSource @endlink.
+     *
+     * Default token can't be canceled.
+     */
+    class CancellationToken final
+    {
+    public:
+        CancellationToken() = default;
+
+        /**
+         * @brief Checks whether cancellation is requested.
+         */
+        [[nodiscard]] bool is_cancellation_requested() const noexcept;
+
+        /**
+         * @brief Throws @link OperationCanceledError @endlink, if cancellation is requested.
+         */
+        void throw_if_cancellation_requested() const;
+
+    private:
+        friend class CancellationSource;
+
+        std::shared_ptr<const std::atomic<bool>> m_is_canceled;
+
+        explicit CancellationToken(std::shared_ptr<const std::atomic<bool>> is_canceled);
+    };
+
+    /**
+     * @brief Represents a source of cancellation requests, shared with operations by tokens.
+     */
+    class CancellationSource final
+    {
+    public:
+        CancellationSource();
+
+        /**
+         * @brief Gets token, bound to the source.
+         */
+        [[nodiscard]] CancellationToken get_token() const;
+
+        /**
+         * @brief Requests cancellation of operations, observing tokens of the source.
+         */
+        void cancel() noexcept;
+
+        /**
+         * @brief Checks whether cancellation is requested.
+         */
+        [[nodiscard]] bool is_cancellation_requested() const noexcept;
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_is_canceled;
+    };
+}
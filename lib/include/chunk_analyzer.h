@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/cancellation.h"
+#include "../include/directory_scanner.h"
+#include "../include/io_throttle.h"
+#include "../include/path_store.h"
+#include "../include/search_progress.h"
+
+namespace bayan
+{
+    /**
+     * @brief Options of content-defined chunking.
+     */
+    struct ChunkingOptions
+    {
+        /**
+         * @brief Minimum chunk size in bytes. No cut point is searched before it.
+         */
+        size_t min_chunk_size = 2 * 1024;
+
+        /**
+         * @brief Expected chunk size in bytes. It is rounded down to a power of two.
+         */
+        size_t average_chunk_size = 8 * 1024;
+
+        /**
+         * @brief Maximum chunk size in bytes.
+         */
+        size_t max_chunk_size = 64 * 1024;
+
+        /**
+         * @brief Maximum count of files sharing a chunk, for which the chunk is counted in file pairs.
+         * Commonly shared chunks, e.g. runs of zeros, are counted only in totals, so pairs don't grow quadratically.
+         */
+        size_t max_pair_fanout = 64;
+    };
+
+    /**
+     * @brief Finds content-defined cut points with the FastCDC gear rolling hash.
+     *
+     * A cut point depends only on the bytes before it, so an insertion or an append shifts
+     * only nearby chunks and the rest of the content is split into the same chunks.
+     * Normalized chunking is used: a stricter mask before the expected size and a looser one after it.
+     */
+    class ContentChunker final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link ContentChunker::ContentChunker @endlink.
+         *
+         * @param options chunking options.
+         */
+        explicit ContentChunker(const ChunkingOptions& options = {});
+
+        /**
+         * @brief Finds the end of the first chunk of data.
+         *
+         * @param data content bytes.
+         *
+         * @param size count of bytes. If it is less than the maximum chunk size, data must end the content.
+         *
+         * @return chunk size.
+         */
+        [[nodiscard]] size_t find_cut(const char* data, size_t size) const noexcept;
+
+        /**
+         * @brief Gets maximum chunk size in bytes.
+         */
+        [[nodiscard]] size_t get_max_chunk_size() const noexcept;
+
+    private:
+        size_t m_min_chunk_size;
+        size_t m_average_chunk_size;
+        size_t m_max_chunk_size;
+        std::uint64_t m_strict_mask;
+        std::uint64_t m_loose_mask;
+    };
+
+    /**
+     * @brief Result of chunk-level analysis.
+     */
+    struct ChunkReport
+    {
+        /**
+         * @brief Pair of files, which share chunks.
+         */
+        struct FilePair
+        {
+            PathStore::FileId first;
+            PathStore::FileId second;
+
+            /**
+             * @brief Total size of distinct chunks, present in both files.
+             */
+            std::uint64_t shared_bytes;
+        };
+
+        /**
+         * @brief Storage of analyzed paths, referenced by file ids.
+         */
+        PathStore paths;
+
+        /**
+         * @brief File pairs, which share chunks, in descending order of shared bytes.
+         */
+        std::vector<FilePair> pairs;
+
+        /**
+         * @brief Total size of analyzed files.
+         */
+        std::uint64_t total_bytes = 0;
+
+        /**
+         * @brief Total size of distinct chunks, i.e. size of analyzed files in a chunk-level deduplicating storage.
+         */
+        std::uint64_t unique_bytes = 0;
+
+        /**
+         * @brief Count of chunks of all files.
+         */
+        size_t chunks_count = 0;
+
+        /**
+         * @brief Count of distinct chunks.
+         */
+        size_t unique_chunks_count = 0;
+    };
+
+    /**
+     * @brief Represents functionality to find partial duplication of files at chunk level.
+     *
+     * Every found file is read once sequentially and split into content-defined chunks.
+     * Chunk digests are indexed across all files, whatever their size, so shared content
+     * of appended, re-exported or slightly changed files is found.
+     * Chunks are identified by MD5 digests, as 32-bit checksums collide too often at chunk counts of large trees.
+     */
+    class ChunkAnalyzer final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link ChunkAnalyzer::ChunkAnalyzer @endlink.
+         *
+         * @param options chunking options.
+         *
+         * @param min_file_size_bytes minimum file size in bytes.
+         */
+        explicit ChunkAnalyzer(const ChunkingOptions& options = {}, size_t min_file_size_bytes = 1);
+
+        /**
+         * @brief Scans directories and reports chunks shared between found files.
+         *
+         * @param dir_paths collection of paths to target directories.
+         *
+         * @param exclude_dirs collection of paths to directories that must be excluded from analysis.
+         *
+         * @param file_mask defines which file names would be analyzed.
+         *
+         * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
+         *
+         * @return chunk report.
+         */
+        ChunkReport analyze(const std::vector<std::string>& dir_paths, const std::vector<std::string>& exclude_dirs,
+            const std::string& file_mask, bool is_recursive) const;
+
+        /**
+         * @brief Sets options of directory scanning. Archives are analyzed as files, since their members can't be read as files.
+         * Memory lean scanning is off, since files of unique sizes still share chunks.
+         *
+         * @param scan_options scan options.
+         */
+        void set_scan_options(const ScanOptions& scan_options) noexcept;
+
+        /**
+         * @brief Sets token, which stops analysis with @link OperationCanceledError @endlink, when canceled.
+         *
+         * @param cancellation_token cancellation token.
+         */
+        void set_cancellation_token(const CancellationToken& cancellation_token);
+
+        /**
+         * @brief Sets reporter of scanned files and chunked bytes.
+         *
+         * @param progress_reporter progress reporter, which outlives the analysis, or nullptr.
+         */
+        void set_progress_reporter(ProgressReporter* progress_reporter) noexcept;
+
+        /**
+         * @brief Sets throttle of file reads and metadata operations.
+         *
+         * @param throttle I/O throttle or nullptr.
+         */
+        void set_throttle(std::shared_ptr<IoThrottle> throttle) noexcept;
+
+    private:
+        ChunkingOptions m_options;
+        ContentChunker m_chunker;
+        size_t m_min_file_size_bytes;
+        ScanOptions m_scan_options;
+        CancellationToken m_cancellation_token;
+        ProgressReporter* m_progress_reporter;
+        std::shared_ptr<IoThrottle> m_throttle;
+    };
+}
@@ -1,21 +1,28 @@
 #pragma once
 
-#include <boost/bimap/multiset_of.hpp>
-#include <boost/bimap/unordered_set_of.hpp>
-#include <fstream>
-#include <list>
-#include <memory>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <string>
 
+#include "../include/block_reader.h"
 #include "../include/hashing.h"
+#include "../include/tracing.h"
 
 using namespace bayan::hashing;
 
 namespace bayan
 {
     /**
-     * @brief Represents a file content, that can be compared with other same instance
-     * by comparing fix sized blocks of hashed content.
+     * @brief Represents a file content, that is read by fix sized blocks. Blocks are hashed
+     * and compared by the comparison engine.
+     *
+     * Blocks, that lie in holes of a sparse file, aren't read: they consist of zeros,
+     * so files of different data/hole layouts but same content are still equal.
+     *
+     * @tparam TReader block reader policy.
      */
+    template <typename TReader = PosixBlockReader>
     class ComparableFileContent final
     {
     public:
@@ -25,75 +32,134 @@ namespace bayan
          * @param file_path path to file.
          *
          * @param readable_block_size content block size to be read from file.
+         */
+        ComparableFileContent(const std::string& file_path, size_t readable_block_size)
+            : m_reader{file_path},
+            m_file_size{boost::filesystem::file_size(file_path)},
+            m_block_size{readable_block_size},
+            m_bytes_read{0},
+            m_position{0},
+            m_data_begin{0},
+            m_data_end{0}
+        {}
+
+        /**
+         * @brief Creates instance of @link ComparableFileContent::ComparableFileContent @endlink
+         * for a file of already known size.
+         *
+         * @param file_path path to file.
          *
-         * @param hash_ptr pointer to hashing object.
+         * @param readable_block_size content block size to be read from file.
+         *
+         * @param file_size size of file in bytes.
          */
-        ComparableFileContent(const std::string& file_path, size_t readable_block_size, const std::shared_ptr<IHash>& hash_ptr);
+        ComparableFileContent(const std::string& file_path, size_t readable_block_size, std::uintmax_t file_size)
+            : m_reader{file_path},
+            m_file_size{file_size},
+            m_block_size{readable_block_size},
+            m_bytes_read{0},
+            m_position{0},
+            m_data_begin{0},
+            m_data_end{0}
+        {}
 
         ComparableFileContent(const ComparableFileContent&) = delete;
 
         /**
          * @brief ComparableFileContent move ctor.
          */
-        ComparableFileContent(ComparableFileContent&&) noexcept;
+        ComparableFileContent(ComparableFileContent&&) noexcept = default;
 
         /**
-         * @brief Attepmts to retrieve a hash from the next fix sized block of file content.
+         * @brief Reads the next fix sized block of file content without hashing it.
+         * The last block is padded with zeros, a block after the end of file consists of zeros.
          *
-         * @param next_hash reference to hashed content.
+         * @param block destination buffer of block size.
          *
-         * @return result indicates, whether the hash retrieving process was successful or not.
+         * @return count of bytes read from file.
          */
-        bool try_get_next_hash(std::string& next_hash);
+        size_t read_next_block(char* block)
+        {
+            TraceSpan span("io", "read_block");
+            size_t count = 0;
+            if (m_reader.is_open() && !try_skip_hole_block())
+            {
+                count = m_reader.read(block, m_block_size);
+                m_bytes_read += count;
+                m_position += count;
+
+                if (count < m_block_size || m_position >= m_file_size)
+                {
+                    m_reader.close();
+                }
+            }
+
+            std::memset(block + count, 0, m_block_size - count);
+            span.set_argument(count);
+            return count;
+        }
 
         /**
-         * @brief get_total_hash retrieves hash from whole already read content.
+         * @brief Skips the next fix sized block of file content, if it lies in a hole of a sparse file.
+         * A skipped block consists of zeros.
          *
-         * @return hashed string.
+         * @return true, if the block is skipped without reading.
          */
-        std::string get_hash_from_already_read_content() const;
+        bool try_skip_hole_block()
+        {
+            if (!m_reader.is_open())
+            {
+                return false;
+            }
+
+            // Layout is looked up once per data extent, so dense files cost two lookups.
+            if (m_position >= m_data_end)
+            {
+                m_data_begin = m_reader.find_data(m_position);
+                m_data_end = m_data_begin == no_data_offset ? no_data_offset : m_reader.find_hole(m_data_begin);
+            }
+
+            const auto block_end = std::min<std::uintmax_t>(m_position + m_block_size, m_file_size);
+            if (block_end > m_data_begin)
+            {
+                return false;
+            }
+
+            m_reader.skip(block_end - m_position);
+            m_position = block_end;
+            if (m_position >= m_file_size)
+            {
+                m_reader.close();
+            }
+            return true;
+        }
 
         /**
-         * @brief reset resets hash iterator.
-         */
-        void reset() noexcept;
-
-        /**
-         * @brief operator == compare two instances of @link ComparableFileContent @endlink.
-         *
-         * @param f1 first instance.
+         * @brief get_bytes_read gets count of bytes, read from file so far.
          *
-         * @param f2 second instance.
-         *
-         * @return comporiosn result.
+         * @return count of read bytes.
          */
-        friend bool operator==(ComparableFileContent& f1, ComparableFileContent& f2);
+        std::uintmax_t get_bytes_read() const noexcept
+        {
+            return m_bytes_read;
+        }
 
         ComparableFileContent& operator =(const ComparableFileContent&) = delete;
 
         /**
-         * @brief operator = ComparableFileContent move assign,ent operator.
+         * @brief operator = ComparableFileContent move assignment operator.
          *
          * @return reference to assigned instance.
          */
-        ComparableFileContent& operator =(ComparableFileContent&&) noexcept;
+        ComparableFileContent& operator =(ComparableFileContent&&) noexcept = default;
 
     private:
-        std::string m_file_path;
-        std::ifstream m_fs;
-        size_t m_file_size;
+        TReader m_reader;
+        std::uintmax_t m_file_size;
         size_t m_block_size;
-
-        std::list<std::string> m_cached_hashes;
-        std::list<std::string>::iterator m_current_cached_position;
-        const static std::list<std::string>::iterator m_default_iterator_position;
-
-        std::weak_ptr<IHash> m_hash_ptr;
-
-        bool try_get_from_fs(std::string& next_hash);
+        std::uintmax_t m_bytes_read;
+        std::uintmax_t m_position;
+        std::uintmax_t m_data_begin;
+        std::uintmax_t m_data_end;
     };
-
-    inline const std::list<std::string>::iterator ComparableFileContent::m_default_iterator_position = std::list<std::string>::iterator{};
-
-    bool operator==(ComparableFileContent& f1, ComparableFileContent& f2);
 }
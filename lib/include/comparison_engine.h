@@ -0,0 +1,414 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../include/cancellation.h"
+#include "../include/comparable_file_content.h"
+#include "../include/digest_group_table.h"
+#include "../include/duplicate_groups.h"
+#include "../include/group_scheduler.h"
+#include "../include/io_throttle.h"
+#include "../include/search_budget.h"
+#include "../include/search_progress.h"
+#include "../include/tar_archive.h"
+#include "../include/tracing.h"
+
+namespace bayan
+{
+    /**
+     * @brief Represents functionality to find identical files inside groups of same sized files.
+     *
+     * Files of a group are split into partitions of identical content so far. At each step
+     * the next block of every partitioned file is read, all the blocks are hashed in one batch
+     * and each partition is split by the block digests. Files left alone are not read anymore.
+     * Files, that fit into one block, are read whole, hashed and closed at once.
+     * Blocks in holes of sparse files are neither read nor hashed, they get the digest of a zero block.
+     * Archive members aren't read either, their blocks are already hashed in a pass over the archive.
+     *
+     * The engine is specialized at compile time, so no virtual calls are made per block.
+     *
+     * @tparam THasher hasher type. It hashes single inputs and batches of equal-length blocks.
+     *
+     * @tparam TReader block reader policy.
+     */
+    template <typename THasher, typename TReader>
+    class ComparisonEngine final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link ComparisonEngine::ComparisonEngine @endlink.
+         *
+         * @param block_size content block size to be read from file.
+         *
+         * @param hasher hashing object.
+         */
+        explicit ComparisonEngine(size_t block_size, THasher hasher = {})
+            : m_block_size{block_size},
+            m_batch_size{std::clamp<size_t>(max_batch_bytes / std::max<size_t>(block_size, 1), 1, max_batch_size)},
+            m_hasher{hasher}
+        {}
+
+        /**
+         * @brief Sets throttle of file reads.
+         *
+         * @param throttle I/O throttle, which outlives the engine, or nullptr.
+         */
+        void set_throttle(IoThrottle* throttle) noexcept
+        {
+            m_throttle = throttle;
+        }
+
+        /**
+         * @brief Sets archive members with hashed blocks, which are compared by their digests.
+         *
+         * @param archive_members archive members, which outlive the engine, or nullptr.
+         */
+        void set_archive_members(const ArchiveMembers* archive_members) noexcept
+        {
+            m_archive_members = archive_members;
+        }
+
+        /**
+         * @brief Compares files of the group and splits them into partitions of identical files.
+         *
+         * @param task group of same sized files.
+         *
+         * @param path_store storage of paths, referenced by file ids.
+         *
+         * @param budget search budget.
+         *
+         * @param cancellation_token cancellation token.
+         *
+         * @param progress progress reporter.
+         *
+         * @return false, if the budget is exhausted before all files are compared.
+         */
+        bool resolve_group(const GroupScheduler::Task& task, const PathStore& path_store,
+            BudgetTracker& budget, const CancellationToken& cancellation_token, ProgressReporter& progress)
+        {
+            m_file_ids = task.file_ids;
+            m_file_size = task.file_size;
+            if (!load_member_digests())
+            {
+                return false;
+            }
+
+            if (m_file_size <= m_block_size)
+            {
+                return resolve_small_files(path_store, budget, cancellation_token, progress);
+            }
+
+            m_file_content_cache.clear();
+            m_file_content_cache.resize(m_file_ids.size());
+            m_block_digests.resize(m_file_ids.size());
+
+            // Partitions hold positions of files in the task.
+            m_partition_members.resize(m_file_ids.size());
+            std::iota(m_partition_members.begin(), m_partition_members.end(), 0);
+            m_partition_offsets.assign({ 0, m_partition_members.size() });
+            m_partition_digests.assign(1, Digest{});
+            if (m_partition_members.size() < 2)
+            {
+                m_partition_members.clear();
+                m_partition_offsets.assign(1, 0);
+                m_partition_digests.clear();
+            }
+
+            const auto blocks_count = (m_file_size + m_block_size - 1) / m_block_size;
+            for (std::uintmax_t block = 0; block < blocks_count && !m_partition_members.empty(); ++block)
+            {
+                if (!hash_next_blocks(block, path_store, budget, cancellation_token, progress))
+                {
+                    m_partition_members.clear();
+                    m_partition_offsets.assign(1, 0);
+                    m_partition_digests.clear();
+                    m_file_content_cache.clear();
+                    return false;
+                }
+                split_partitions();
+            }
+
+            m_file_content_cache.clear();
+            return true;
+        }
+
+        /**
+         * @brief Appends identical files of the last resolved group to a flat members array,
+         * where each group is delimited by offsets.
+         *
+         * @param members flat array of file ids.
+         *
+         * @param offsets offsets of groups in the members array. It must start with 0.
+         *
+         * @param infos properties of groups. Group digests chain digests of all blocks.
+         */
+        void append_groups(std::vector<PathStore::FileId>& members, std::vector<size_t>& offsets,
+            std::vector<DuplicateGroups::GroupInfo>& infos) const
+        {
+            members.reserve(members.size() + m_partition_members.size());
+            for (size_t partition = 0; partition + 1 < m_partition_offsets.size(); ++partition)
+            {
+                for (size_t i = m_partition_offsets[partition]; i < m_partition_offsets[partition + 1]; ++i)
+                {
+                    members.push_back(m_file_ids[m_partition_members[i]]);
+                }
+                offsets.push_back(members.size());
+                infos.push_back({ m_file_size, m_partition_digests[partition] });
+            }
+        }
+
+    private:
+        using FileContent = ComparableFileContent<TReader>;
+
+        static constexpr size_t max_batch_size = 64;
+        static constexpr size_t max_batch_bytes = 4 * 1024 * 1024;
+
+        size_t m_block_size;
+        size_t m_batch_size;
+        [[no_unique_address]] THasher m_hasher;
+        IoThrottle* m_throttle = nullptr;
+        const ArchiveMembers* m_archive_members = nullptr;
+        std::vector<std::span<const Digest>> m_member_digests;
+
+        std::span<const PathStore::FileId> m_file_ids;
+        std::uintmax_t m_file_size = 0;
+        std::vector<std::optional<FileContent>> m_file_content_cache;
+        std::vector<Digest> m_block_digests;
+
+        std::vector<PathStore::FileId> m_partition_members;
+        std::vector<size_t> m_partition_offsets;
+        std::vector<Digest> m_partition_digests;
+        std::vector<PathStore::FileId> m_next_partition_members;
+        std::vector<size_t> m_next_partition_offsets;
+        std::vector<Digest> m_next_partition_digests;
+        std::vector<bool> m_is_partitioned;
+        DigestGroupTable m_digest_groups;
+
+        std::vector<char> m_batch_buffer;
+        std::vector<const char*> m_batch_blocks;
+        std::vector<PathStore::FileId> m_batch_positions;
+        std::vector<Digest> m_batch_digests;
+        std::optional<Digest> m_zero_block_digest;
+
+        bool resolve_small_files(const PathStore& path_store, BudgetTracker& budget,
+            const CancellationToken& cancellation_token, ProgressReporter& progress)
+        {
+            const auto file_size = static_cast<size_t>(m_file_size);
+            m_batch_buffer.resize(m_batch_size * m_block_size);
+            m_batch_digests.resize(m_batch_size);
+            m_digest_groups.clear();
+            m_partition_members.clear();
+            m_partition_offsets.assign(1, 0);
+            m_partition_digests.clear();
+
+            for (size_t begin = 0; begin < m_file_ids.size(); begin += m_batch_size)
+            {
+                cancellation_token.throw_if_cancellation_requested();
+                if (budget.is_exhausted())
+                {
+                    return false;
+                }
+
+                const auto end = std::min(begin + m_batch_size, m_file_ids.size());
+                std::uintmax_t bytes_read = 0;
+                m_batch_blocks.clear();
+                m_batch_positions.clear();
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (!m_member_digests[i].empty())
+                    {
+                        m_digest_groups.add(m_member_digests[i].front(), static_cast<PathStore::FileId>(i));
+                        continue;
+                    }
+
+                    // A file, changed since the scan, is padded with zeros up to the scanned size.
+                    char* content = m_batch_buffer.data() + m_batch_blocks.size() * m_block_size;
+                    if (m_throttle != nullptr)
+                    {
+                        m_throttle->acquire_read(file_size, cancellation_token, budget.get_deadline());
+                    }
+                    TraceSpan span("io", "read_file", file_size);
+                    TReader reader(path_store.get_path(m_file_ids[i]));
+                    const auto count = reader.read(content, file_size);
+                    std::memset(content + count, 0, file_size - count);
+                    bytes_read += count;
+                    m_batch_blocks.push_back(content);
+                    m_batch_positions.push_back(static_cast<PathStore::FileId>(i));
+                }
+                budget.add_bytes_read(bytes_read);
+                progress.add_bytes_hashed(bytes_read);
+
+                if (!m_batch_blocks.empty())
+                {
+                    TraceSpan span("hash", "hash_batch", m_batch_blocks.size());
+                    m_hasher(m_batch_blocks, file_size, std::span(m_batch_digests.data(), m_batch_blocks.size()));
+                }
+                for (size_t i = 0; i < m_batch_positions.size(); ++i)
+                {
+                    m_digest_groups.add(m_batch_digests[i], m_batch_positions[i]);
+                }
+            }
+
+            m_digest_groups.append_groups(m_partition_members, m_partition_offsets);
+            for (DigestGroupTable::GroupId group = 0; group < m_digest_groups.groups_count(); ++group)
+            {
+                if (m_digest_groups.group_size(group) >= 2)
+                {
+                    m_partition_digests.push_back(m_digest_groups.group_digest(group));
+                }
+            }
+            return true;
+        }
+
+        bool hash_next_blocks(std::uintmax_t block_index, const PathStore& path_store, BudgetTracker& budget,
+            const CancellationToken& cancellation_token, ProgressReporter& progress)
+        {
+            m_batch_buffer.resize(m_batch_size * m_block_size);
+            m_batch_digests.resize(m_batch_size);
+
+            for (size_t begin = 0; begin < m_partition_members.size(); begin += m_batch_size)
+            {
+                cancellation_token.throw_if_cancellation_requested();
+                if (budget.is_exhausted())
+                {
+                    return false;
+                }
+
+                const auto end = std::min(begin + m_batch_size, m_partition_members.size());
+                std::uintmax_t bytes_read = 0;
+                m_batch_blocks.clear();
+                m_batch_positions.clear();
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const auto position = m_partition_members[i];
+                    if (!m_member_digests[position].empty())
+                    {
+                        m_block_digests[position] = m_member_digests[position][block_index];
+                        continue;
+                    }
+
+                    auto& file_content = get_file_content(position, path_store);
+                    if (file_content.try_skip_hole_block())
+                    {
+                        m_block_digests[position] = get_zero_block_digest();
+                        continue;
+                    }
+
+                    if (m_throttle != nullptr)
+                    {
+                        m_throttle->acquire_read(m_block_size, cancellation_token, budget.get_deadline());
+                    }
+                    char* block = m_batch_buffer.data() + m_batch_blocks.size() * m_block_size;
+                    bytes_read += file_content.read_next_block(block);
+                    m_batch_blocks.push_back(block);
+                    m_batch_positions.push_back(position);
+                }
+                budget.add_bytes_read(bytes_read);
+                progress.add_bytes_hashed(bytes_read);
+
+                if (!m_batch_blocks.empty())
+                {
+                    TraceSpan span("hash", "hash_batch", m_batch_blocks.size());
+                    m_hasher(m_batch_blocks, m_block_size, std::span(m_batch_digests.data(), m_batch_blocks.size()));
+                }
+                for (size_t i = 0; i < m_batch_positions.size(); ++i)
+                {
+                    m_block_digests[m_batch_positions[i]] = m_batch_digests[i];
+                }
+            }
+
+            return true;
+        }
+
+        void split_partitions()
+        {
+            m_next_partition_members.clear();
+            m_next_partition_offsets.assign(1, 0);
+            m_next_partition_digests.clear();
+
+            for (size_t partition = 0; partition + 1 < m_partition_offsets.size(); ++partition)
+            {
+                m_digest_groups.clear();
+                for (size_t i = m_partition_offsets[partition]; i < m_partition_offsets[partition + 1]; ++i)
+                {
+                    m_digest_groups.add(m_block_digests[m_partition_members[i]], m_partition_members[i]);
+                }
+                m_digest_groups.append_groups(m_next_partition_members, m_next_partition_offsets);
+                for (DigestGroupTable::GroupId group = 0; group < m_digest_groups.groups_count(); ++group)
+                {
+                    if (m_digest_groups.group_size(group) >= 2)
+                    {
+                        m_next_partition_digests.push_back(
+                            chain_digest(m_hasher, m_partition_digests[partition], m_digest_groups.group_digest(group)));
+                    }
+                }
+            }
+
+            // Files without a pair are dropped, so their descriptors are released.
+            m_is_partitioned.assign(m_file_ids.size(), false);
+            for (const auto position : m_next_partition_members)
+            {
+                m_is_partitioned[position] = true;
+            }
+            for (const auto position : m_partition_members)
+            {
+                if (!m_is_partitioned[position])
+                {
+                    m_file_content_cache[position].reset();
+                }
+            }
+
+            std::swap(m_partition_members, m_next_partition_members);
+            std::swap(m_partition_offsets, m_next_partition_offsets);
+            std::swap(m_partition_digests, m_next_partition_digests);
+        }
+
+        bool load_member_digests()
+        {
+            m_member_digests.assign(m_file_ids.size(), {});
+            if (m_archive_members == nullptr)
+            {
+                return true;
+            }
+
+            // A member is left unhashed, only when the budget is exhausted.
+            for (size_t i = 0; i < m_file_ids.size(); ++i)
+            {
+                if (m_archive_members->contains(m_file_ids[i]))
+                {
+                    m_member_digests[i] = m_archive_members->get_digests(m_file_ids[i]);
+                    if (m_member_digests[i].empty())
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        const Digest& get_zero_block_digest()
+        {
+            if (!m_zero_block_digest.has_value())
+            {
+                m_zero_block_digest = m_hasher(std::string(m_block_size, '\0'));
+            }
+            return *m_zero_block_digest;
+        }
+
+        FileContent& get_file_content(PathStore::FileId position, const PathStore& path_store)
+        {
+            auto& file_content = m_file_content_cache[position];
+            if (!file_content.has_value())
+            {
+                file_content.emplace(path_store.get_path(m_file_ids[position]), m_block_size, m_file_size);
+            }
+            return *file_content;
+        }
+    };
+}
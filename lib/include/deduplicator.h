@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../include/duplicate_groups.h"
+
+namespace bayan
+{
+    /**
+     * @brief Options of the space reclaiming action.
+     */
+    struct DeduplicationOptions
+    {
+        /**
+         * @brief Only report what would be deduplicated, without changing files.
+         */
+        bool dry_run = false;
+
+        /**
+         * @brief Replace duplicates with hard links, when the file system can't share extents.
+         */
+        bool hardlink_fallback = false;
+    };
+
+    /**
+     * @brief Result of the space reclaiming action.
+     */
+    struct DeduplicationReport
+    {
+        /**
+         * @brief Count of deduplicated files. In dry run it is count of files, which can be deduplicated.
+         */
+        size_t files_deduplicated = 0;
+
+        /**
+         * @brief Count of files, which share extents with the first file of their group.
+         */
+        size_t files_cloned = 0;
+
+        /**
+         * @brief Count of files, replaced with hard links to the first file of their group.
+         */
+        size_t files_linked = 0;
+
+        /**
+         * @brief Count of files, which were left untouched because of errors or differing content.
+         */
+        size_t files_failed = 0;
+
+        /**
+         * @brief Count of bytes, which are shared now. In dry run it is count of bytes, which can be shared.
+         */
+        std::uintmax_t bytes_deduplicated = 0;
+
+        /**
+         * @brief Descriptions of failures.
+         */
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * @brief Represents functionality to reclaim space, occupied by duplicate files.
+     *
+     * Every group is submitted to the kernel with batched FIDEDUPERANGE requests (btrfs, XFS),
+     * so the kernel compares the bytes itself and shares extents only if they are equal.
+     */
+    class Deduplicator final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link Deduplicator::Deduplicator @endlink.
+         *
+         * @param options action options.
+         */
+        explicit Deduplicator(const DeduplicationOptions& options = {});
+
+        /**
+         * @brief Deduplicates each group against its first file. Archive members are skipped.
+         *
+         * @param duplicates grouped duplicates.
+         *
+         * @return action report.
+         */
+        DeduplicationReport deduplicate(const DuplicateGroups& duplicates) const;
+
+    private:
+        DeduplicationOptions m_options;
+
+        void deduplicate_group(const DuplicateGroups& duplicates, DuplicateGroups::Group group, DeduplicationReport& report) const;
+
+        static bool is_content_equal(const std::string& source_path, const std::string& destination_path);
+
+        static void link_file(const std::string& source_path, const std::string& destination_path);
+    };
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../include/hashing.h"
+#include "../include/path_store.h"
+
+namespace bayan
+{
+    /**
+     * @brief Represents a flat open-addressing map from binary digest to group of files.
+     *
+     * Members are kept in contiguous arrays in insertion order, so groups are assembled
+     * in linear time. Clearing the table keeps allocated memory for the next use.
+     */
+    class DigestGroupTable final
+    {
+    public:
+        /**
+         * @brief Identifier of a group inside the table.
+         */
+        using GroupId = std::uint32_t;
+
+        /**
+         * @brief Identifier of a missing group.
+         */
+        static constexpr GroupId no_group = std::numeric_limits<GroupId>::max();
+
+        /**
+         * @brief Adds file to the group of the digest. Creates the group, if it is absent.
+         *
+         * @param digest content digest of the file.
+         *
+         * @param file_id file identifier.
+         *
+         * @return identifier of the group the file was added to.
+         */
+        GroupId add(const hashing::Digest& digest, PathStore::FileId file_id);
+
+        /**
+         * @brief Finds the group of the digest.
+         *
+         * @param digest content digest.
+         *
+         * @return group identifier or @link DigestGroupTable::no_group @endlink.
+         */
+        [[nodiscard]] GroupId find(const hashing::Digest& digest) const noexcept;
+
+        /**
+         * @brief Gets count of groups.
+         */
+        [[nodiscard]] size_t groups_count() const noexcept;
+
+        /**
+         * @brief Gets count of members in the group.
+         *
+         * @param group_id group identifier.
+         */
+        [[nodiscard]] size_t group_size(GroupId group_id) const;
+
+        /**
+         * @brief Gets digest of the group.
+         *
+         * @param group_id group identifier.
+         */
+        [[nodiscard]] const hashing::Digest& group_digest(GroupId group_id) const;
+
+        /**
+         * @brief Appends groups to a flat members array, where each group is delimited by offsets.
+         *
+         * @param members flat array of file ids.
+         *
+         * @param offsets offsets of groups in the members array. It must start with 0.
+         *
+         * @param min_group_size groups with less members are skipped.
+         */
+        void append_groups(std::vector<PathStore::FileId>& members, std::vector<size_t>& offsets, size_t min_group_size = 2) const;
+
+        /**
+         * @brief Removes all groups. Allocated memory is kept.
+         */
+        void clear() noexcept;
+
+    private:
+        struct Slot
+        {
+            hashing::Digest digest;
+            GroupId group_id = no_group;
+        };
+
+        std::vector<Slot> m_slots;
+        std::vector<size_t> m_group_slots;
+        std::vector<hashing::Digest> m_group_digests;
+        std::vector<std::uint32_t> m_group_sizes;
+        std::vector<GroupId> m_member_groups;
+        std::vector<PathStore::FileId> m_member_files;
+        mutable std::vector<size_t> m_write_positions;
+
+        [[nodiscard]] size_t find_slot(const hashing::Digest& digest) const noexcept;
+
+        void grow();
+    };
+}
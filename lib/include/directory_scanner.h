@@ -1,16 +1,69 @@
 #pragma once
 
 #include <boost/filesystem.hpp>
+#include <functional>
 #include <string>
 #include <regex>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "../include/cancellation.h"
+#include "../include/io_throttle.h"
+#include "../include/path_store.h"
+#include "../include/search_progress.h"
+#include "../include/tar_archive.h"
+
 using namespace boost::filesystem;
 
 namespace bayan
 {
+    /**
+     * @brief Way of walking directories.
+     */
+    enum class WalkerType
+    {
+        Boost,
+        Native
+    };
+
+    /**
+     * @brief Options of directory scanning.
+     */
+    struct ScanOptions
+    {
+        /**
+         * @brief Scans directories twice. The first pass only counts file sizes in a sketch,
+         * the second one keeps paths only of files, whose size is repeated.
+         */
+        bool is_memory_lean = false;
+
+        /**
+         * @brief Binary logarithm of count of sketch counters in a row.
+         */
+        size_t sketch_size_log2 = 24;
+
+        /**
+         * @brief Follows symbolic links to directories and files. Each real directory is walked
+         * and each real file is reported once, identified by its device and inode, so link loops are cut.
+         */
+        bool follow_symlinks = false;
+
+        /**
+         * @brief Directory walker. The native one reads entries with getdents64, classifies them by d_type
+         * and calls statx relative to the parent directory only for files, that match the mask.
+         * It falls back to the boost walker on platforms other than Linux.
+         */
+        WalkerType walker = WalkerType::Boost;
+
+        /**
+         * @brief Reports regular files inside uncompressed tar archives ('*.tar') as virtual paths
+         * 'archive.tar!/member'. Only archive headers are read while scanning. The file mask is applied
+         * to member names, the archive itself is reported, when its own name matches the mask.
+         */
+        bool scan_archives = false;
+    };
+
     /**
      * @brief Reresents funtionality of directory scanning.
      */
@@ -18,9 +71,9 @@ namespace bayan
     {
     public:
         /**
-         * @brief Represents file paths, grouped by file size.
+         * @brief Represents interned file ids, grouped by file size.
          */
-        using GroupedBySizeMap = std::unordered_map<size_t, std::unordered_set<std::string>>;
+        using GroupedBySizeMap = std::unordered_map<size_t, std::vector<PathStore::FileId>>;
 
         /**
          * @brief Creates instance of @link DirectoryScanner::DirectoryScanner @endlink.
@@ -40,26 +93,110 @@ namespace bayan
         DirectoryScanner& operator =(DirectoryScanner&&) = default;
 
         /**
-         * @brief Scans directories and returns collection of found file paths, groupded by file size.
+         * @brief Scans directories and returns collection of found file ids, groupded by file size.
+         * In memory lean mode only sizes of at least two files are returned.
+         *
+         * @param path_store storage, where paths of found files are interned.
          *
          * @param file_mask defines which file names would be included into search.
          *
          * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
          *
-         * @return file paths, grouped by file size.
+         * @return file ids, grouped by file size.
+         */
+        GroupedBySizeMap scan(PathStore& path_store, const std::string& file_mask = ".*", bool is_recursive = true);
+
+        /**
+         * @brief Sets token, which stops scanning with @link OperationCanceledError @endlink, when canceled.
+         *
+         * @param cancellation_token cancellation token.
          */
-        GroupedBySizeMap scan(const std::string& file_mask = ".*", bool is_recursive = true);
+        void set_cancellation_token(const CancellationToken& cancellation_token);
+
+        /**
+         * @brief Sets reporter of visited files. The reporter must outlive scanning.
+         *
+         * @param progress_reporter progress reporter or nullptr.
+         */
+        void set_progress_reporter(ProgressReporter* progress_reporter) noexcept;
+
+        /**
+         * @brief Sets options of scanning.
+         *
+         * @param options scan options.
+         */
+        void set_scan_options(const ScanOptions& options) noexcept;
+
+        /**
+         * @brief Sets throttle of metadata operations. The throttle must outlive scanning.
+         *
+         * @param throttle I/O throttle or nullptr.
+         */
+        void set_throttle(IoThrottle* throttle) noexcept;
+
+        /**
+         * @brief Moves out archive members, found by the last scan. The scanner is left with no members.
+         */
+        [[nodiscard]] ArchiveMembers take_archive_members() noexcept;
 
     private:
+        struct FileIdentity
+        {
+            std::uint64_t device;
+            std::uint64_t inode;
+
+            friend bool operator==(const FileIdentity&, const FileIdentity&) = default;
+        };
+
+        struct FileIdentityHash
+        {
+            size_t operator()(const FileIdentity& identity) const noexcept
+            {
+                return std::hash<std::uint64_t>{}(identity.inode * 0x9e3779b97f4a7c15ull ^ identity.device);
+            }
+        };
+
+        using FileHandler = std::function<void(size_t, PathStore::DirectoryId, const std::string&)>;
+
         std::vector<std::string> m_dir_paths;
         std::vector<std::string> m_exclude_dirs;
         size_t m_min_file_size_bytes;
+        CancellationToken m_cancellation_token;
+        ProgressReporter* m_progress_reporter;
+        ScanOptions m_options;
+        IoThrottle* m_throttle;
+        ArchiveMembers m_archive_members;
+        std::unordered_map<std::string, std::vector<TarMember>> m_archive_headers;
+        std::unordered_set<FileIdentity, FileIdentityHash> m_visited;
+
+        void walk(PathStore*, const std::regex&, bool, const FileHandler&);
+
+        void recursive_scan(PathStore*, const std::regex&, const FileHandler&);
+
+        void top_level_scan(PathStore*, const std::regex&, const FileHandler&);
+
+        void native_scan(PathStore*, const std::regex&, bool, const FileHandler&);
+
+        void native_scan_directory(int, std::string&, PathStore::DirectoryId, PathStore*, const std::regex&, bool,
+            const FileHandler&, std::vector<char>&);
+
+        void handle_native_file(int, const std::string&, const std::string&, PathStore::DirectoryId, const std::regex&,
+            PathStore*, const FileHandler&);
+
+        bool is_excluded(const std::string&) const;
+
+        std::vector<std::string> get_root_paths(bool) const;
+
+        void throttle_metadata();
+
+        void handle_file(const boost::filesystem::path&, PathStore::DirectoryId, const std::regex&, PathStore*, const FileHandler&);
 
-        GroupedBySizeMap recursive_scan(std::regex&&);
+        void handle_archive(const std::string&, const std::string&, PathStore::DirectoryId, const std::regex&,
+            PathStore*, const FileHandler&);
 
-        GroupedBySizeMap top_level_scan(std::regex&&);
+        bool try_visit(const boost::filesystem::path&);
 
-        void handle_file(const boost::filesystem::path&, const std::regex&, GroupedBySizeMap&);
+        bool try_visit(const FileIdentity&);
     };
 }
 
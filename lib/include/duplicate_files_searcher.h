@@ -1,28 +1,54 @@
 #pragma once
 
-#include <boost/bimap.hpp>
-#include <boost/bimap/unordered_set_of.hpp>
-#include <boost/range/iterator_range.hpp>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
 #include <string_view>
 
-#include "../include/comparable_file_content.h"
+#include "../include/block_reader.h"
+#include "../include/cancellation.h"
 #include "../include/directory_scanner.h"
+#include "../include/duplicate_groups.h"
+#include "../include/group_scheduler.h"
 #include "../include/hash_algorithm.h"
 #include "../include/hashing.h"
+#include "../include/io_throttle.h"
+#include "../include/search_budget.h"
+#include "../include/search_progress.h"
 
 namespace bayan
 {
-    namespace
+    /**
+     * @brief Executor, which runs a submitted task, possibly on another thread.
+     */
+    using Executor = std::function<void(std::function<void()>)>;
+
+    /**
+     * @brief Options of an asynchronous search run.
+     */
+    struct AsyncSearchOptions
     {
-        struct FilePath {};
-        struct FileHash {};
+        /**
+         * @brief Executor of the search task. If empty, the search runs on a new detached thread.
+         */
+        Executor executor;
+
+        /**
+         * @brief Token, which stops the search with @link OperationCanceledError @endlink.
+         */
+        CancellationToken cancellation_token;
+
+        /**
+         * @brief Progress callback. It is called on the thread of the search task.
+         */
+        ProgressCallback on_progress;
 
-        using FileHashToPathBimap = boost::bimap<
-            boost::bimaps::unordered_set_of<
-                    boost::bimaps::tagged<std::string, FilePath>>,
-            boost::bimaps::multiset_of<
-                    boost::bimaps::tagged<std::string, FileHash>>>;
-    }
+        /**
+         * @brief Minimal interval between progress callback calls.
+         */
+        std::chrono::milliseconds progress_interval { 100 };
+    };
 
     /**
      * @brief Represents functionality to search duplicate files.
@@ -33,7 +59,7 @@ namespace bayan
         /**
          * @brief Grouped duplicates.
          */
-        using Duplicates = std::vector<std::unordered_set<std::string>>;
+        using Duplicates = DuplicateGroups;
 
         /**
          * @brief Creates instance of @link DuplicateFilesSearcher::DuplicateFilesSearcher @endlink.
@@ -44,7 +70,7 @@ namespace bayan
          *
          * @param min_file_size_bytes minimum file size in bytes.
          */
-        DuplicateFilesSearcher(size_t block_size, HashAlgorithm hash_algorithm, size_t min_file_size_bytes = 1);
+        DuplicateFilesSearcher(size_t block_size, hashing::HashAlgorithm hash_algorithm, size_t min_file_size_bytes = 1);
 
         DuplicateFilesSearcher(const DuplicateFilesSearcher&) = default;
         DuplicateFilesSearcher(DuplicateFilesSearcher&&) = default;
@@ -60,26 +86,93 @@ namespace bayan
          *
          * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
          *
-         * @return grouped duplicates.
+         * @return grouped duplicates. If the search budget is exhausted, groups, which were not compared completely,
+         * are returned as unresolved.
          */
         Duplicates run(const std::vector<std::string>& dir_paths, const std::vector<std::string>& exclude_dirs, const std::string& file_mask = ".*", bool is_recursive = true);
 
+        /**
+         * @brief run_async starts search for duplicate files on the executor.
+         * The searcher settings are copied, so several searches can run concurrently.
+         *
+         * @param options executor, cancellation token and progress callback.
+         *
+         * @param dir_paths collection of paths to target directories.
+         *
+         * @param exclude_dir collection of paths to directories that msut be excluded from the search.
+         *
+         * @param file_mask defines which file names would be included into search.
+         *
+         * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
+         *
+         * @return future of grouped duplicates. It holds @link OperationCanceledError @endlink, if the search was canceled.
+         */
+        std::future<Duplicates> run_async(const AsyncSearchOptions& options, const std::vector<std::string>& dir_paths,
+            const std::vector<std::string>& exclude_dirs, const std::string& file_mask = ".*", bool is_recursive = true) const;
+
+        /**
+         * @brief Sets the order, in which groups of same sized files are compared.
+         *
+         * @param policy scheduling policy.
+         */
+        void set_scheduling_policy(SchedulingPolicy policy) noexcept;
+
+        /**
+         * @brief Sets limits of each search run.
+         *
+         * @param budget search limits.
+         */
+        void set_budget(const SearchBudget& budget) noexcept;
+
+        /**
+         * @brief Sets the way file blocks are read.
+         *
+         * @param block_reader block reader type.
+         */
+        void set_block_reader(BlockReaderType block_reader) noexcept;
+
+        /**
+         * @brief Sets options of directory scanning.
+         *
+         * @param scan_options scan options.
+         */
+        void set_scan_options(const ScanOptions& scan_options) noexcept;
+
+        /**
+         * @brief Sets throttle of file reads and metadata operations. It is shared by all runs,
+         * so its limits may be changed while they run.
+         *
+         * @param throttle I/O throttle or nullptr.
+         */
+        void set_throttle(std::shared_ptr<IoThrottle> throttle) noexcept;
+
         DuplicateFilesSearcher& operator =(const DuplicateFilesSearcher&) = default;
         DuplicateFilesSearcher& operator =(DuplicateFilesSearcher&&) = default;
 
     private:
+        struct SearchContext;
+        struct SearchResult;
+
         size_t m_block_size;
         size_t m_min_file_size_bytes;
-        std::shared_ptr<IHash> m_hash;
-
-        ComparableFileContent& get_file_content(std::unordered_map<std::string, ComparableFileContent>& file_content_cache, const std::string& file_path) const;
+        hashing::HashAlgorithm m_hash_algorithm;
+        SchedulingPolicy m_scheduling_policy;
+        SearchBudget m_budget;
+        BlockReaderType m_block_reader;
+        ScanOptions m_scan_options;
+        std::shared_ptr<IoThrottle> m_throttle;
 
         // [[nodiscard]] GroupedBySizeMap get_files_grouped_by_size(const std::vector<std::string>& dir_paths,
         //     const std::vector<std::string>& exclude_dirs, const std::string& file_mask, bool is_recursive = true);
 
-        [[nodiscard]] static Duplicates build_duplicates(const bayan::DirectoryScanner::GroupedBySizeMap& grouped_by_size, const FileHashToPathBimap& file_path_to_hash);
+        Duplicates search(const std::vector<std::string>& dir_paths, const std::vector<std::string>& exclude_dirs,
+            const std::string& file_mask, bool is_recursive, SearchContext& context) const;
+
+        template <typename THasher>
+        void resolve_groups(const std::vector<GroupScheduler::Task>& tasks, const PathStore& path_store, SearchContext& context, SearchResult& result) const;
 
-        static void replace_file_to_hash(FileHashToPathBimap& file_path_to_hash, const std::string& file_path, const ComparableFileContent& file_content);
+        template <typename THasher, typename TReader>
+        void resolve_groups(const std::vector<GroupScheduler::Task>& tasks, const PathStore& path_store, SearchContext& context, SearchResult& result) const;
     };
 }
 
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../include/hashing.h"
+#include "../include/path_store.h"
+
+namespace bayan
+{
+    /**
+     * @brief Represents groups of duplicate files, identified by interned file ids.
+     *
+     * Members of all groups are kept in one contiguous array, delimited by group offsets.
+     * When a search is cut short, groups of candidates, which were not compared completely,
+     * are kept separately as unresolved.
+     */
+    class DuplicateGroups final
+    {
+    public:
+        /**
+         * @brief Group of identical files.
+         */
+        using Group = std::span<const PathStore::FileId>;
+
+        /**
+         * @brief Common properties of files in a group.
+         */
+        struct GroupInfo
+        {
+            /**
+             * @brief Size of each file in bytes.
+             */
+            std::uintmax_t file_size = 0;
+
+            /**
+             * @brief Content digest. It is comparable only between runs with the same block size and hash algorithm.
+             */
+            hashing::Digest digest;
+        };
+
+        DuplicateGroups() = default;
+
+        /**
+         * @brief Creates instance of @link DuplicateGroups::DuplicateGroups @endlink.
+         *
+         * @param paths storage of paths, referenced by file ids.
+         *
+         * @param members file ids of all groups, stored one group after another.
+         *
+         * @param offsets offsets of groups in the members array, starting with 0 and ending with members count.
+         *
+         * @param infos properties of each group.
+         *
+         * @param unresolved_members file ids of all unresolved groups of candidates.
+         *
+         * @param unresolved_offsets offsets of unresolved groups in the unresolved members array.
+         */
+        DuplicateGroups(PathStore&& paths, std::vector<PathStore::FileId>&& members, std::vector<size_t>&& offsets,
+            std::vector<GroupInfo>&& infos, std::vector<PathStore::FileId>&& unresolved_members = {}, std::vector<size_t>&& unresolved_offsets = { 0 });
+
+        /**
+         * @brief Gets count of groups.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * @brief Checks whether there are no groups.
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets group of identical files by index.
+         *
+         * @param index group index.
+         *
+         * @return file ids of the group.
+         */
+        Group operator[](size_t index) const;
+
+        /**
+         * @brief Gets common properties of files in the group.
+         *
+         * @param index group index.
+         */
+        [[nodiscard]] const GroupInfo& get_info(size_t index) const;
+
+        /**
+         * @brief Gets count of unresolved groups of candidates.
+         */
+        [[nodiscard]] size_t unresolved_size() const noexcept;
+
+        /**
+         * @brief Gets unresolved group of candidates by index. Its files have the same size,
+         * but were not compared completely.
+         *
+         * @param index unresolved group index.
+         *
+         * @return file ids of the unresolved group.
+         */
+        [[nodiscard]] Group get_unresolved(size_t index) const;
+
+        /**
+         * @brief Checks whether all candidates were compared.
+         */
+        [[nodiscard]] bool is_complete() const noexcept;
+
+        /**
+         * @brief Rebuilds full path of the file.
+         *
+         * @param file_id file identifier.
+         *
+         * @return full file path.
+         */
+        [[nodiscard]] std::string get_path(PathStore::FileId file_id) const;
+
+        /**
+         * @brief Gets storage of paths.
+         */
+        [[nodiscard]] const PathStore& get_paths() const noexcept;
+
+        /**
+         * @brief Marks files, which are members of archives and don't exist on disk by their paths.
+         *
+         * @param file_ids file ids of archive members.
+         */
+        void set_archive_members(std::vector<PathStore::FileId>&& file_ids);
+
+        /**
+         * @brief Checks whether the file is a member of an archive.
+         *
+         * @param file_id file identifier.
+         */
+        [[nodiscard]] bool is_archive_member(PathStore::FileId file_id) const;
+
+    private:
+        PathStore m_paths;
+        std::vector<PathStore::FileId> m_members;
+        std::vector<size_t> m_offsets { 0 };
+        std::vector<GroupInfo> m_infos;
+        std::vector<PathStore::FileId> m_unresolved_members;
+        std::vector<size_t> m_unresolved_offsets { 0 };
+        std::vector<PathStore::FileId> m_archive_members;
+
+        static Group get_group(const std::vector<PathStore::FileId>& members, const std::vector<size_t>& offsets, size_t index);
+    };
+}
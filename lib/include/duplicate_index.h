@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "../include/duplicate_groups.h"
+#include "../include/hash_algorithm.h"
+#include "../include/hashing.h"
+#include "../include/path_store.h"
+
+namespace bayan
+{
+    /**
+     * @brief Represents an on-disk index of search results, which is memory mapped and used without parsing.
+     *
+     * The index is a header followed by 8-byte aligned sections in native byte order:
+     * groups sorted by file size and digest, group members, group of each file, file path hashes
+     * sorted for lookup, and the interned path entries and names of the @link PathStore @endlink.
+     */
+    class DuplicateIndex final
+    {
+    public:
+        /**
+         * @brief Format version. It is changed on every incompatible change of the layout.
+         */
+        static constexpr std::uint32_t version = 1;
+
+        /**
+         * @brief Identifier of a group inside the index.
+         */
+        using GroupId = std::uint32_t;
+
+        /**
+         * @brief Identifier of a missing group.
+         */
+        static constexpr GroupId no_group = std::numeric_limits<GroupId>::max();
+
+        /**
+         * @brief Stored group of identical files.
+         */
+        struct GroupRecord
+        {
+            std::uint64_t file_size;
+            hashing::Digest digest;
+            std::uint64_t members_offset;
+            std::uint32_t members_count;
+            std::uint32_t reserved;
+        };
+
+        /**
+         * @brief Writes search results to the index file. The file is replaced atomically.
+         *
+         * @param file_path path to the index file.
+         *
+         * @param duplicates search results.
+         *
+         * @param hash_algorithm hash algorithm of group digests.
+         *
+         * @param block_size block size of group digests.
+         */
+        static void write(const std::string& file_path, const DuplicateGroups& duplicates,
+            hashing::HashAlgorithm hash_algorithm, size_t block_size);
+
+        /**
+         * @brief Maps the index file into memory.
+         *
+         * @param file_path path to the index file.
+         */
+        explicit DuplicateIndex(const std::string& file_path);
+
+        DuplicateIndex(const DuplicateIndex&) = delete;
+
+        /**
+         * @brief DuplicateIndex move ctor.
+         */
+        DuplicateIndex(DuplicateIndex&& other) noexcept;
+
+        ~DuplicateIndex();
+
+        /**
+         * @brief Gets hash algorithm of group digests.
+         */
+        [[nodiscard]] hashing::HashAlgorithm get_hash_algorithm() const noexcept;
+
+        /**
+         * @brief Gets block size of group digests.
+         */
+        [[nodiscard]] size_t get_block_size() const noexcept;
+
+        /**
+         * @brief Gets count of groups.
+         */
+        [[nodiscard]] size_t groups_count() const noexcept;
+
+        /**
+         * @brief Gets the group by identifier.
+         *
+         * @param group_id group identifier.
+         */
+        [[nodiscard]] const GroupRecord& get_group(GroupId group_id) const;
+
+        /**
+         * @brief Gets file ids of the group.
+         *
+         * @param group_id group identifier.
+         */
+        [[nodiscard]] std::span<const PathStore::FileId> get_members(GroupId group_id) const;
+
+        /**
+         * @brief Finds groups of files of the size.
+         *
+         * @param file_size size of file in bytes.
+         *
+         * @return range of group identifiers.
+         */
+        [[nodiscard]] std::pair<GroupId, GroupId> find_by_size(std::uintmax_t file_size) const noexcept;
+
+        /**
+         * @brief Finds the group of files of the size and content digest.
+         *
+         * @param file_size size of file in bytes.
+         *
+         * @param digest content digest.
+         *
+         * @return group identifier or @link DuplicateIndex::no_group @endlink.
+         */
+        [[nodiscard]] GroupId find_by_digest(std::uintmax_t file_size, const hashing::Digest& digest) const noexcept;
+
+        /**
+         * @brief Finds the group of the file.
+         *
+         * @param file_path full path of the file, as it was found by the search.
+         *
+         * @return group identifier or @link DuplicateIndex::no_group @endlink, if the file is unknown or has no duplicates.
+         */
+        [[nodiscard]] GroupId find_by_path(const std::string& file_path) const;
+
+        /**
+         * @brief Gets interned paths of all searched files.
+         */
+        [[nodiscard]] const PathStoreView& get_paths() const noexcept;
+
+        DuplicateIndex& operator =(const DuplicateIndex&) = delete;
+
+        /**
+         * @brief DuplicateIndex move assignment operator.
+         *
+         * @return reference to assigned instance.
+         */
+        DuplicateIndex& operator =(DuplicateIndex&& other) noexcept;
+
+    private:
+        struct Header;
+
+        struct PathHashRecord
+        {
+            std::uint64_t path_hash;
+            PathStore::FileId file_id;
+            std::uint32_t reserved;
+        };
+
+        void* m_data;
+        size_t m_size;
+        const Header* m_header;
+        std::span<const GroupRecord> m_groups;
+        std::span<const PathStore::FileId> m_members;
+        std::span<const GroupId> m_file_groups;
+        std::span<const PathHashRecord> m_path_hashes;
+        PathStoreView m_paths;
+
+        void unmap() noexcept;
+
+        template <typename T>
+        std::span<const T> get_section(std::uint64_t offset, std::uint64_t count) const;
+
+        static std::uint64_t get_path_hash(std::string_view path) noexcept;
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../include/directory_scanner.h"
+
+namespace bayan
+{
+    /**
+     * @brief Order, in which groups of same sized files are resolved.
+     */
+    enum class SchedulingPolicy
+    {
+        LargestPayoffFirst,
+        LargestFileFirst,
+        SmallestGroupFirst,
+        ScanOrder
+    };
+
+    /**
+     * @brief Represents functionality to order groups of same sized files before comparison.
+     */
+    class GroupScheduler final
+    {
+    public:
+        /**
+         * @brief Group of same sized files, scheduled for comparison.
+         */
+        struct Task
+        {
+            size_t file_size;
+            std::span<const PathStore::FileId> file_ids;
+        };
+
+        /**
+         * @brief Creates instance of @link GroupScheduler::GroupScheduler @endlink.
+         *
+         * @param policy scheduling policy.
+         */
+        explicit GroupScheduler(SchedulingPolicy policy = SchedulingPolicy::LargestPayoffFirst);
+
+        /**
+         * @brief Orders groups, that can contain duplicates, according to the policy.
+         *
+         * @param grouped_by_size file ids, grouped by file size.
+         *
+         * @return ordered groups with at least two files.
+         */
+        [[nodiscard]] std::vector<Task> schedule(const DirectoryScanner::GroupedBySizeMap& grouped_by_size) const;
+
+        /**
+         * @brief Gets count of bytes, which can be reclaimed, if all files of the group are identical.
+         *
+         * @param task scheduled group.
+         *
+         * @return expected reclaimable bytes.
+         */
+        [[nodiscard]] static std::uintmax_t get_expected_payoff(const Task& task) noexcept;
+
+    private:
+        SchedulingPolicy m_policy;
+    };
+}
@@ -1,9 +1,116 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <boost/crc.hpp>
+#include <cstdint>
+#include <cstring>
+#include <span>
 #include <string>
+#include <string_view>
 
 namespace bayan::hashing
 {
+    /**
+     * @brief Binary digest of hashed content.
+     *
+     * Algorithms with shorter output fill the leading bytes and leave the rest zeroed.
+     */
+    struct Digest
+    {
+        std::array<std::uint8_t, 16> bytes{};
+
+        friend bool operator==(const Digest&, const Digest&) = default;
+    };
+
+    /**
+     * @brief The MD5 hasher without virtual dispatch.
+     *
+     * Besides single inputs it hashes batches of equal-length blocks in parallel SIMD lanes.
+     */
+    struct Md5Hasher
+    {
+        /**
+         * @brief Gets binary digest from input bytes.
+         *
+         * @return binary digest.
+         */
+        Digest operator()(std::string_view input) const noexcept;
+
+        /**
+         * @brief Gets binary digests from equal-length blocks. Blocks are hashed in parallel vector lanes
+         * (16 with AVX-512, 8 with AVX2, 4 otherwise), the rest are hashed one by one.
+         *
+         * @param blocks pointers to blocks.
+         *
+         * @param block_size size of every block.
+         *
+         * @param digests destination digests, one per block.
+         */
+        void operator()(std::span<const char* const> blocks, size_t block_size, std::span<Digest> digests) const noexcept;
+    };
+
+    /**
+     * @brief The CRC32 hasher without virtual dispatch, to be inlined into read loops.
+     */
+    struct Crc32Hasher
+    {
+        /**
+         * @brief Gets binary digest from input bytes.
+         *
+         * @return binary digest.
+         */
+        Digest operator()(std::string_view input) const noexcept
+        {
+            boost::crc_32_type crc;
+            crc.process_bytes(input.data(), input.size());
+
+            const std::uint32_t checksum = crc.checksum();
+            Digest result;
+            std::memcpy(result.bytes.data(), &checksum, sizeof(checksum));
+            return result;
+        }
+
+        /**
+         * @brief Gets binary digests from equal-length blocks.
+         *
+         * @param blocks pointers to blocks.
+         *
+         * @param block_size size of every block.
+         *
+         * @param digests destination digests, one per block.
+         */
+        void operator()(std::span<const char* const> blocks, size_t block_size, std::span<Digest> digests) const noexcept
+        {
+            const size_t count = std::min(blocks.size(), digests.size());
+            for (size_t i = 0; i < count; ++i)
+            {
+                digests[i] = (*this)(std::string_view(blocks[i], block_size));
+            }
+        }
+    };
+
+    /**
+     * @brief Gets digest of a content, which continues the previous content by one more block.
+     * Chaining block digests gives the digest of a whole file, block by block.
+     *
+     * @param hasher hashing object.
+     *
+     * @param previous digest of the previous content. Default digest starts the chain.
+     *
+     * @param block digest of the next block.
+     *
+     * @return chained digest.
+     */
+    template <typename THasher>
+    Digest chain_digest(const THasher& hasher, const Digest& previous, const Digest& block)
+    {
+        std::array<std::uint8_t, 2 * sizeof(Digest::bytes)> input;
+        std::memcpy(input.data(), previous.bytes.data(), previous.bytes.size());
+        std::memcpy(input.data() + previous.bytes.size(), block.bytes.data(), block.bytes.size());
+        return hasher(std::string_view(reinterpret_cast<const char*>(input.data()), input.size()));
+    }
+
     /**
      * @brief Interface represents functionality to get hash from input string.
      */
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include "../include/cancellation.h"
+
+namespace bayan
+{
+    /**
+     * @brief Represents a token bucket, which limits rate of operations. Its rate can be changed at any time.
+     *
+     * The bucket holds up to one second of tokens. A request larger than the bucket is granted
+     * as soon as the bucket isn't in debt, and following requests wait until the debt is repaid.
+     */
+    class RateLimiter final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link RateLimiter::RateLimiter @endlink.
+         *
+         * @param rate count of tokens per second. Zero means no limit.
+         */
+        explicit RateLimiter(std::uint64_t rate = 0);
+
+        /**
+         * @brief Sets count of tokens per second. Zero means no limit.
+         *
+         * @param rate count of tokens per second.
+         */
+        void set_rate(std::uint64_t rate);
+
+        /**
+         * @brief Gets count of tokens per second.
+         */
+        [[nodiscard]] std::uint64_t get_rate() const noexcept;
+
+        /**
+         * @brief Takes tokens, waiting until they are available.
+         * Waiting stops with @link OperationCanceledError @endlink, when canceled, and ends at the deadline,
+         * so a search with a time budget notices its exhaustion instead of waiting.
+         *
+         * @param tokens count of tokens.
+         *
+         * @param cancellation_token cancellation token.
+         *
+         * @param deadline time, after which tokens are taken without waiting.
+         */
+        void acquire(std::uint64_t tokens, const CancellationToken& cancellation_token = {},
+            std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    private:
+        std::atomic<std::uint64_t> m_rate;
+        std::mutex m_mutex;
+        double m_tokens;
+        std::chrono::steady_clock::time_point m_last_refill;
+    };
+
+    /**
+     * @brief I/O limits. Zero value means no limit.
+     */
+    struct ThrottleLimits
+    {
+        /**
+         * @brief Maximum count of bytes read from compared files per second.
+         */
+        std::uint64_t bytes_per_second = 0;
+
+        /**
+         * @brief Maximum count of read calls for compared files per second.
+         */
+        std::uint64_t reads_per_second = 0;
+
+        /**
+         * @brief Maximum count of metadata operations of directory scanning per second.
+         */
+        std::uint64_t metadata_ops_per_second = 0;
+    };
+
+    /**
+     * @brief Throttles reads and metadata operations of a search. It may be shared by concurrent searches,
+     * and its limits may be changed while searches run.
+     */
+    class IoThrottle final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link IoThrottle::IoThrottle @endlink.
+         *
+         * @param limits I/O limits.
+         */
+        explicit IoThrottle(const ThrottleLimits& limits = {});
+
+        /**
+         * @brief Sets I/O limits.
+         *
+         * @param limits I/O limits.
+         */
+        void set_limits(const ThrottleLimits& limits);
+
+        /**
+         * @brief Gets I/O limits.
+         */
+        [[nodiscard]] ThrottleLimits get_limits() const noexcept;
+
+        /**
+         * @brief Waits until a read of the size is allowed.
+         *
+         * @param bytes count of bytes to read.
+         *
+         * @param cancellation_token cancellation token.
+         *
+         * @param deadline time, after which the read is allowed without waiting.
+         */
+        void acquire_read(std::uint64_t bytes, const CancellationToken& cancellation_token = {},
+            std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+        /**
+         * @brief Waits until a metadata operation is allowed.
+         *
+         * @param cancellation_token cancellation token.
+         */
+        void acquire_metadata(const CancellationToken& cancellation_token = {});
+
+    private:
+        RateLimiter m_bytes;
+        RateLimiter m_reads;
+        RateLimiter m_metadata_ops;
+    };
+
+    /**
+     * @brief Sets idle I/O scheduling class for the process, so its I/O is served only when a disk is otherwise idle.
+     *
+     * @return false, if the class is not supported.
+     */
+    bool set_idle_io_priority() noexcept;
+}
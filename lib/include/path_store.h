@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bayan
+{
+    class PathStoreView;
+
+    /**
+     * @brief Represents an interned storage of file system paths.
+     *
+     * Every directory and file is stored as a reference to the parent directory
+     * plus a name slice in a shared character arena, so common directory prefixes
+     * are kept only once. Full paths are rebuilt on demand.
+     */
+    class PathStore final
+    {
+    public:
+        /**
+         * @brief Identifier of a stored file.
+         */
+        using FileId = std::uint32_t;
+
+        /**
+         * @brief Identifier of a stored directory.
+         */
+        using DirectoryId = std::uint32_t;
+
+        /**
+         * @brief Parent identifier of root directories.
+         */
+        static constexpr DirectoryId no_directory = std::numeric_limits<DirectoryId>::max();
+
+        /**
+         * @brief Stored directory or file: a name slice in the character arena and the parent directory.
+         * The layout is fixed, so entries can be written to disk and mapped back as is.
+         */
+        struct Entry
+        {
+            std::uint64_t name_offset;
+            DirectoryId parent;
+            std::uint32_t name_length;
+        };
+
+        /**
+         * @brief Adds a directory to the store.
+         *
+         * @param parent identifier of the parent directory or @link PathStore::no_directory @endlink for a root.
+         *
+         * @param name directory name. For a root directory it is a full path.
+         *
+         * @return identifier of the added directory.
+         */
+        DirectoryId add_directory(DirectoryId parent, std::string_view name);
+
+        /**
+         * @brief Adds a file to the store.
+         *
+         * @param parent identifier of the parent directory.
+         *
+         * @param name file name.
+         *
+         * @return identifier of the added file.
+         */
+        FileId add_file(DirectoryId parent, std::string_view name);
+
+        /**
+         * @brief Rebuilds full path of the file.
+         *
+         * @param file_id file identifier.
+         *
+         * @return full file path.
+         */
+        [[nodiscard]] std::string get_path(FileId file_id) const;
+
+        /**
+         * @brief Rebuilds full path of the directory.
+         *
+         * @param directory_id directory identifier.
+         *
+         * @return full directory path.
+         */
+        [[nodiscard]] std::string get_directory_path(DirectoryId directory_id) const;
+
+        /**
+         * @brief Gets the file name without parent directories.
+         *
+         * @param file_id file identifier.
+         *
+         * @return file name.
+         */
+        [[nodiscard]] std::string_view get_name(FileId file_id) const;
+
+        /**
+         * @brief Gets the parent directory of the file.
+         *
+         * @param file_id file identifier.
+         *
+         * @return parent directory identifier.
+         */
+        [[nodiscard]] DirectoryId get_parent(FileId file_id) const;
+
+        /**
+         * @brief Gets count of stored files.
+         */
+        [[nodiscard]] size_t files_count() const noexcept;
+
+        /**
+         * @brief Gets count of stored directories.
+         */
+        [[nodiscard]] size_t directories_count() const noexcept;
+
+        /**
+         * @brief Gets read-only view of the stored entries. It is invalidated, when the store is changed.
+         */
+        [[nodiscard]] PathStoreView get_view() const noexcept;
+
+    private:
+        std::vector<Entry> m_directories;
+        std::vector<Entry> m_files;
+        std::vector<char> m_names;
+
+        Entry make_entry(DirectoryId parent, std::string_view name);
+    };
+
+    /**
+     * @brief Represents read-only interned paths over external arrays of entries and names,
+     * e.g. of a @link PathStore @endlink or of a memory mapped file.
+     */
+    class PathStoreView final
+    {
+    public:
+        PathStoreView() = default;
+
+        /**
+         * @brief Creates instance of @link PathStoreView::PathStoreView @endlink.
+         *
+         * @param directories directory entries.
+         *
+         * @param files file entries.
+         *
+         * @param names character arena of entry names.
+         */
+        PathStoreView(std::span<const PathStore::Entry> directories, std::span<const PathStore::Entry> files,
+            std::span<const char> names) noexcept;
+
+        /**
+         * @brief Rebuilds full path of the file.
+         *
+         * @param file_id file identifier.
+         *
+         * @return full file path.
+         */
+        [[nodiscard]] std::string get_path(PathStore::FileId file_id) const;
+
+        /**
+         * @brief Rebuilds full path of the directory.
+         *
+         * @param directory_id directory identifier.
+         *
+         * @return full directory path.
+         */
+        [[nodiscard]] std::string get_directory_path(PathStore::DirectoryId directory_id) const;
+
+        /**
+         * @brief Gets the file name without parent directories.
+         *
+         * @param file_id file identifier.
+         *
+         * @return file name.
+         */
+        [[nodiscard]] std::string_view get_name(PathStore::FileId file_id) const;
+
+        /**
+         * @brief Gets the parent directory of the file.
+         *
+         * @param file_id file identifier.
+         *
+         * @return parent directory identifier.
+         */
+        [[nodiscard]] PathStore::DirectoryId get_parent(PathStore::FileId file_id) const;
+
+        /**
+         * @brief Gets count of files.
+         */
+        [[nodiscard]] size_t files_count() const noexcept;
+
+        /**
+         * @brief Gets count of directories.
+         */
+        [[nodiscard]] size_t directories_count() const noexcept;
+
+        /**
+         * @brief Gets directory entries.
+         */
+        [[nodiscard]] std::span<const PathStore::Entry> get_directories() const noexcept;
+
+        /**
+         * @brief Gets file entries.
+         */
+        [[nodiscard]] std::span<const PathStore::Entry> get_files() const noexcept;
+
+        /**
+         * @brief Gets character arena of entry names.
+         */
+        [[nodiscard]] std::span<const char> get_names() const noexcept;
+
+    private:
+        std::span<const PathStore::Entry> m_directories;
+        std::span<const PathStore::Entry> m_files;
+        std::span<const char> m_names;
+
+        const PathStore::Entry& get_entry(std::span<const PathStore::Entry> entries, size_t index) const;
+
+        std::string_view get_entry_name(const PathStore::Entry& entry) const;
+
+        void append_directory_path(PathStore::DirectoryId directory_id, std::string& path) const;
+    };
+}
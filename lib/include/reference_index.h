@@ -0,0 +1,218 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/block_reader.h"
+#include "../include/cancellation.h"
+#include "../include/directory_scanner.h"
+#include "../include/hash_algorithm.h"
+#include "../include/hashing.h"
+#include "../include/io_throttle.h"
+#include "../include/path_store.h"
+#include "../include/search_progress.h"
+
+namespace bayan
+{
+    /**
+     * @brief Represents query files, which are found in a reference index, with their reference copies.
+     */
+    class ReferenceMatches final
+    {
+    public:
+        /**
+         * @brief Reference copies of a query file.
+         */
+        using References = std::span<const PathStore::FileId>;
+
+        ReferenceMatches() = default;
+
+        /**
+         * @brief Creates instance of @link ReferenceMatches::ReferenceMatches @endlink.
+         *
+         * @param query_paths storage of query paths, referenced by query file ids.
+         *
+         * @param query_files ids of matched query files.
+         *
+         * @param references ids of reference files, stored one query file after another.
+         *
+         * @param reference_offsets offsets of references of each query file, starting with 0.
+         */
+        ReferenceMatches(PathStore&& query_paths, std::vector<PathStore::FileId>&& query_files,
+            std::vector<PathStore::FileId>&& references, std::vector<size_t>&& reference_offsets);
+
+        /**
+         * @brief Gets count of matched query files.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * @brief Checks whether no query file is matched.
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets path of the matched query file.
+         *
+         * @param index index of matched query file.
+         */
+        [[nodiscard]] std::string get_query_path(size_t index) const;
+
+        /**
+         * @brief Gets reference copies of the matched query file.
+         *
+         * @param index index of matched query file.
+         *
+         * @return ids of reference files. Their paths are kept by the reference index.
+         */
+        [[nodiscard]] References get_references(size_t index) const;
+
+    private:
+        PathStore m_query_paths;
+        std::vector<PathStore::FileId> m_query_files;
+        std::vector<PathStore::FileId> m_references;
+        std::vector<size_t> m_reference_offsets { 0 };
+    };
+
+    /**
+     * @brief Represents an index of reference files, which are looked up by size and content digest.
+     *
+     * The index is built by scanning reference directories once. Reference files are hashed lazily:
+     * digests of all reference files of a size are computed and memoized, when a query file of that
+     * size comes first. So the cost of a query depends on the query set, not on the reference set.
+     *
+     * Files are looked up by digests of their whole content, so reference files are read in full
+     * instead of being pruned block by block, as the comparison engine does. In return, memoized
+     * digests serve every later query file and query run without reading reference files again.
+     */
+    class ReferenceIndex final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link ReferenceIndex::ReferenceIndex @endlink.
+         *
+         * @param block_size content block size to be read from file.
+         *
+         * @param hash_algorithm hash algorithm type.
+         *
+         * @param min_file_size_bytes minimum file size in bytes.
+         */
+        ReferenceIndex(size_t block_size, hashing::HashAlgorithm hash_algorithm, size_t min_file_size_bytes = 1);
+
+        /**
+         * @brief Scans reference directories and indexes found files by size.
+         *
+         * @param dir_paths collection of paths to reference directories.
+         *
+         * @param exclude_dirs collection of paths to directories that must be excluded from the index.
+         *
+         * @param file_mask defines which file names would be indexed.
+         *
+         * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
+         */
+        void build(const std::vector<std::string>& dir_paths, const std::vector<std::string>& exclude_dirs,
+            const std::string& file_mask, bool is_recursive);
+
+        /**
+         * @brief Finds files of query directories, which are already present in the index.
+         *
+         * @param dir_paths collection of paths to query directories.
+         *
+         * @param exclude_dirs collection of paths to directories that must be excluded from the query.
+         *
+         * @param file_mask defines which file names would be queried.
+         *
+         * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
+         *
+         * @return matched query files with their reference copies.
+         */
+        ReferenceMatches query(const std::vector<std::string>& dir_paths, const std::vector<std::string>& exclude_dirs,
+            const std::string& file_mask, bool is_recursive);
+
+        /**
+         * @brief Sets the way file blocks are read.
+         *
+         * @param block_reader block reader type.
+         */
+        void set_block_reader(BlockReaderType block_reader) noexcept;
+
+        /**
+         * @brief Sets options of directory scanning. Memory lean scanning is off, since a query file of a unique size
+         * may still have reference copies. Archives are scanned as files, since their members can't be read as files.
+         *
+         * @param scan_options scan options.
+         */
+        void set_scan_options(const ScanOptions& scan_options) noexcept;
+
+        /**
+         * @brief Sets token, which stops building and querying with @link OperationCanceledError @endlink, when canceled.
+         *
+         * @param cancellation_token cancellation token.
+         */
+        void set_cancellation_token(const CancellationToken& cancellation_token);
+
+        /**
+         * @brief Sets reporter of scanned files and hashed bytes.
+         *
+         * @param progress_reporter progress reporter, which outlives building and querying, or nullptr.
+         */
+        void set_progress_reporter(ProgressReporter* progress_reporter) noexcept;
+
+        /**
+         * @brief Sets throttle of file reads and metadata operations of building and querying.
+         *
+         * @param throttle I/O throttle or nullptr.
+         */
+        void set_throttle(std::shared_ptr<IoThrottle> throttle) noexcept;
+
+        /**
+         * @brief Gets path of the reference file.
+         *
+         * @param file_id reference file identifier.
+         */
+        [[nodiscard]] std::string get_path(PathStore::FileId file_id) const;
+
+        /**
+         * @brief Gets count of indexed reference files.
+         */
+        [[nodiscard]] size_t files_count() const noexcept;
+
+        /**
+         * @brief Gets count of reference files hashed so far.
+         */
+        [[nodiscard]] size_t hashed_files_count() const noexcept;
+
+    private:
+        struct DigestEntry
+        {
+            hashing::Digest digest;
+            PathStore::FileId file_id;
+        };
+
+        size_t m_block_size;
+        size_t m_min_file_size_bytes;
+        hashing::HashAlgorithm m_hash_algorithm;
+        BlockReaderType m_block_reader;
+        ScanOptions m_scan_options;
+        CancellationToken m_cancellation_token;
+        ProgressReporter* m_progress_reporter;
+        std::shared_ptr<IoThrottle> m_throttle;
+
+        PathStore m_paths;
+        DirectoryScanner::GroupedBySizeMap m_files_by_size;
+        std::unordered_map<size_t, std::vector<DigestEntry>> m_digests_by_size;
+        size_t m_hashed_files_count;
+
+        void configure_scanner(DirectoryScanner& scanner) const;
+
+        const std::vector<DigestEntry>& get_size_digests(size_t file_size);
+
+        hashing::Digest get_file_digest(const std::string& file_path, size_t file_size) const;
+
+        template <typename THasher>
+        hashing::Digest get_file_digest(const std::string& file_path, size_t file_size) const;
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace bayan
+{
+    /**
+     * @brief Limits of a single search run. Zero value means no limit.
+     */
+    struct SearchBudget
+    {
+        /**
+         * @brief Maximum duration of the run, including directory scanning.
+         */
+        std::chrono::milliseconds max_time { 0 };
+
+        /**
+         * @brief Maximum count of bytes, read from compared files.
+         */
+        std::uintmax_t max_bytes_read = 0;
+    };
+
+    /**
+     * @brief Tracks consumption of the @link SearchBudget @endlink during a run.
+     */
+    class BudgetTracker final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link BudgetTracker::BudgetTracker @endlink and starts the clock.
+         *
+         * @param budget limits of the run.
+         */
+        explicit BudgetTracker(const SearchBudget& budget);
+
+        /**
+         * @brief Accounts bytes, read from compared files.
+         *
+         * @param bytes_read count of read bytes.
+         */
+        void add_bytes_read(std::uintmax_t bytes_read) noexcept;
+
+        /**
+         * @brief Gets count of bytes, read from compared files.
+         */
+        [[nodiscard]] std::uintmax_t get_bytes_read() const noexcept;
+
+        /**
+         * @brief Checks whether any limit is reached. Once reached, the budget stays exhausted.
+         */
+        [[nodiscard]] bool is_exhausted() noexcept;
+
+        /**
+         * @brief Gets time, when the time limit is reached, or the maximum time point, if there is no time limit.
+         */
+        [[nodiscard]] std::chrono::steady_clock::time_point get_deadline() const noexcept;
+
+    private:
+        SearchBudget m_budget;
+        std::chrono::steady_clock::time_point m_deadline;
+        std::uintmax_t m_bytes_read;
+        bool m_is_exhausted;
+    };
+}
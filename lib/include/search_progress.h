@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace bayan
+{
+    /**
+     * @brief Snapshot of a search run progress.
+     */
+    struct SearchProgress
+    {
+        /**
+         * @brief Count of visited regular files.
+         */
+        size_t files_scanned = 0;
+
+        /**
+         * @brief Count of bytes, read and hashed from compared files.
+         */
+        std::uintmax_t bytes_hashed = 0;
+
+        /**
+         * @brief Count of resolved groups of same sized files.
+         */
+        size_t groups_resolved = 0;
+
+        /**
+         * @brief Count of groups of same sized files to resolve. It is known after directories are scanned.
+         */
+        size_t groups_total = 0;
+    };
+
+    /**
+     * @brief Callback, receiving progress of a search run.
+     */
+    using ProgressCallback = std::function<void(const SearchProgress&)>;
+
+    /**
+     * @brief Accumulates progress of a search run and passes it to a callback not more often than an interval.
+     */
+    class ProgressReporter final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link ProgressReporter::ProgressReporter @endlink, which reports nothing.
+         */
+        ProgressReporter() = default;
+
+        /**
+         * @brief Creates instance of @link ProgressReporter::ProgressReporter @endlink.
+         *
+         * @param callback progress callback.
+         *
+         * @param interval minimal interval between callback calls.
+         */
+        ProgressReporter(ProgressCallback callback, std::chrono::milliseconds interval);
+
+        /**
+         * @brief Accounts visited regular files.
+         */
+        void add_files_scanned(size_t count);
+
+        /**
+         * @brief Accounts read and hashed bytes.
+         */
+        void add_bytes_hashed(std::uintmax_t count);
+
+        /**
+         * @brief Accounts resolved groups.
+         */
+        void add_groups_resolved(size_t count);
+
+        /**
+         * @brief Sets count of groups to resolve.
+         */
+        void set_groups_total(size_t count);
+
+        /**
+         * @brief Passes current progress to the callback regardless of the interval.
+         */
+        void flush();
+
+        /**
+         * @brief Gets current progress.
+         */
+        [[nodiscard]] const SearchProgress& get_progress() const noexcept;
+
+    private:
+        ProgressCallback m_callback;
+        std::chrono::milliseconds m_interval { 0 };
+        std::chrono::steady_clock::time_point m_next_report;
+        SearchProgress m_progress;
+
+        void report_if_due();
+    };
+}
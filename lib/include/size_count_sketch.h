@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bayan
+{
+    /**
+     * @brief Represents a fixed-size counting sketch of file sizes, which tells whether a size may occur more than once.
+     *
+     * Each size is counted in two rows of saturating counters. A size is reported as repeated only if
+     * both its counters reached two, so repeated sizes are never missed, and a unique size is reported
+     * as repeated only when both its counters collide with other sizes.
+     */
+    class SizeCountSketch final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link SizeCountSketch::SizeCountSketch @endlink.
+         *
+         * @param counters_count_log2 binary logarithm of count of counters in a row.
+         */
+        explicit SizeCountSketch(size_t counters_count_log2);
+
+        /**
+         * @brief Counts one more file of the size.
+         *
+         * @param file_size size of file in bytes.
+         */
+        void add(std::uintmax_t file_size) noexcept;
+
+        /**
+         * @brief Checks whether files of the size may have been counted more than once.
+         *
+         * @param file_size size of file in bytes.
+         */
+        [[nodiscard]] bool may_be_repeated(std::uintmax_t file_size) const noexcept;
+
+    private:
+        static constexpr size_t rows_count = 2;
+
+        std::vector<std::uint8_t> m_counters;
+        std::uint64_t m_mask;
+
+        [[nodiscard]] size_t get_index(std::uintmax_t file_size, size_t row) const noexcept;
+    };
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/block_reader.h"
+#include "../include/cancellation.h"
+#include "../include/hashing.h"
+#include "../include/io_throttle.h"
+#include "../include/path_store.h"
+#include "../include/search_budget.h"
+#include "../include/search_progress.h"
+#include "../include/tracing.h"
+
+namespace bayan
+{
+    /**
+     * @brief Regular file, stored in a tar archive.
+     */
+    struct TarMember
+    {
+        /**
+         * @brief Member path inside the archive, without leading './' and '/'.
+         */
+        std::string name;
+
+        /**
+         * @brief Offset of member data in the archive.
+         */
+        std::uintmax_t offset;
+
+        /**
+         * @brief Member size in bytes.
+         */
+        std::uintmax_t size;
+    };
+
+    /**
+     * @brief Checks whether the file name is a name of an uncompressed tar archive.
+     *
+     * @param file_name file name.
+     */
+    [[nodiscard]] bool is_tar_archive(std::string_view file_name) noexcept;
+
+    /**
+     * @brief Reads regular file members of a tar archive from its headers. Member data isn't read.
+     * ustar, GNU long names and pax path and size records are supported. Reading stops at the first
+     * invalid header, so a file, which isn't a tar archive, has no members. It also stops at an extended header
+     * over 1 MiB or at a size, which overflows offsets.
+     *
+     * @param archive_path path to the archive.
+     *
+     * @param throttle throttle of header reads or nullptr.
+     *
+     * @param cancellation_token cancellation token.
+     *
+     * @return members in order of their offsets.
+     */
+    std::vector<TarMember> read_tar_members(const std::string& archive_path, IoThrottle* throttle = nullptr,
+        const CancellationToken& cancellation_token = {});
+
+    /**
+     * @brief Represents archive members, found by scanning, and their block digests.
+     *
+     * Members are compared without extraction. Member headers are read, when archives are scanned,
+     * in each scan pass of memory lean mode. Then data of each archive is read in one sequential pass,
+     * and all blocks of candidate members are hashed. Members are compared by the kept digests,
+     * as if their blocks were read from files.
+     */
+    class ArchiveMembers final
+    {
+    public:
+        /**
+         * @brief Identifier of an archive.
+         */
+        using ArchiveId = std::uint32_t;
+
+        /**
+         * @brief Adds an archive.
+         *
+         * @param archive_path path to the archive.
+         *
+         * @return identifier of the archive.
+         */
+        ArchiveId add_archive(const std::string& archive_path);
+
+        /**
+         * @brief Adds a member of the archive, which was stored as a file.
+         *
+         * @param file_id file identifier of the member.
+         *
+         * @param archive_id identifier of the archive.
+         *
+         * @param member member of the archive.
+         */
+        void add_member(PathStore::FileId file_id, ArchiveId archive_id, const TarMember& member);
+
+        /**
+         * @brief Checks whether the file is an archive member.
+         *
+         * @param file_id file identifier.
+         */
+        [[nodiscard]] bool contains(PathStore::FileId file_id) const;
+
+        /**
+         * @brief Checks whether there are no members.
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets file identifiers of all members.
+         *
+         * @return sorted file ids.
+         */
+        [[nodiscard]] std::vector<PathStore::FileId> get_file_ids() const;
+
+        /**
+         * @brief Gets block digests of the member. A member, which fits into one block, has a single digest of its content.
+         *
+         * @param file_id file identifier of the member.
+         *
+         * @return digests, or an empty span, if the member isn't hashed.
+         */
+        [[nodiscard]] std::span<const hashing::Digest> get_digests(PathStore::FileId file_id) const;
+
+        /**
+         * @brief Hashes all blocks of the candidate members, reading data of each archive in one sequential pass.
+         * Blocks are hashed as the comparison engine does: the last block is padded with zeros,
+         * a member, that fits into one block, is hashed without padding.
+         *
+         * Members are hashed in full before groups are compared, so they don't benefit from the early exit
+         * on a differing block, and hashing may use up the bytes budget before the first group is compared.
+         * In return an archive is never read at random offsets, block by block.
+         *
+         * @tparam THasher hasher type. It hashes single inputs and batches of equal-length blocks.
+         *
+         * @param file_ids candidate files. Files, which aren't archive members, are ignored.
+         *
+         * @param block_size content block size.
+         *
+         * @param budget search budget. Members, left when it is exhausted, aren't hashed.
+         *
+         * @param cancellation_token cancellation token.
+         *
+         * @param progress progress reporter.
+         *
+         * @param throttle throttle of reads or nullptr.
+         */
+        template <typename THasher>
+        void hash(std::span<const PathStore::FileId> file_ids, size_t block_size, BudgetTracker& budget,
+            const CancellationToken& cancellation_token, ProgressReporter& progress, IoThrottle* throttle, THasher hasher = {})
+        {
+            std::vector<Location*> candidates;
+            for (const auto file_id : file_ids)
+            {
+                const auto location = m_locations.find(file_id);
+                if (location != m_locations.end() && location->second.digests_count == 0)
+                {
+                    candidates.push_back(&location->second);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(), [](const auto& left, const auto& right)
+            {
+                return left->archive_id != right->archive_id
+                    ? left->archive_id < right->archive_id
+                    : left->offset < right->offset;
+            });
+
+            const auto batch_size = std::clamp<size_t>(max_batch_bytes / std::max<size_t>(block_size, 1), 1, max_batch_size);
+            std::vector<char> buffer(batch_size * block_size);
+            std::vector<const char*> blocks;
+            std::vector<hashing::Digest> digests(batch_size);
+
+            for (size_t begin = 0; begin < candidates.size();)
+            {
+                const auto archive_id = candidates[begin]->archive_id;
+                TraceSpan span("io", "read_archive");
+                PosixBlockReader reader(m_archive_paths[archive_id]);
+                std::uintmax_t position = 0;
+
+                for (; begin < candidates.size() && candidates[begin]->archive_id == archive_id; ++begin)
+                {
+                    cancellation_token.throw_if_cancellation_requested();
+                    if (budget.is_exhausted())
+                    {
+                        return;
+                    }
+
+                    // Only forward skips are made, so the archive data is read in one sequential pass.
+                    auto& location = *candidates[begin];
+                    reader.skip(location.offset - position);
+                    position = location.offset + location.size;
+
+                    location.digests_begin = m_digests.size();
+
+                    if (location.size <= block_size)
+                    {
+                        const auto size = static_cast<size_t>(location.size);
+                        if (throttle != nullptr)
+                        {
+                            throttle->acquire_read(size, cancellation_token, budget.get_deadline());
+                        }
+                        const auto count = reader.read(buffer.data(), size);
+                        std::memset(buffer.data() + count, 0, size - count);
+                        m_digests.push_back(hasher(std::string_view(buffer.data(), size)));
+                        budget.add_bytes_read(count);
+                        progress.add_bytes_hashed(count);
+                    }
+                    else
+                    {
+                        for (std::uintmax_t left = location.size; left > 0;)
+                        {
+                            std::uintmax_t bytes_read = 0;
+                            blocks.clear();
+                            while (left > 0 && blocks.size() < batch_size)
+                            {
+                                char* block = buffer.data() + blocks.size() * block_size;
+                                const auto size = static_cast<size_t>(std::min<std::uintmax_t>(left, block_size));
+                                if (throttle != nullptr)
+                                {
+                                    throttle->acquire_read(size, cancellation_token, budget.get_deadline());
+                                }
+                                const auto count = reader.read(block, size);
+                                std::memset(block + count, 0, block_size - count);
+                                blocks.push_back(block);
+                                bytes_read += count;
+                                left -= size;
+                            }
+                            hasher(blocks, block_size, std::span(digests.data(), blocks.size()));
+                            m_digests.insert(m_digests.end(), digests.begin(), digests.begin() + blocks.size());
+                            budget.add_bytes_read(bytes_read);
+                            progress.add_bytes_hashed(bytes_read);
+                        }
+                    }
+                    location.digests_count = m_digests.size() - location.digests_begin;
+                }
+            }
+        }
+
+    private:
+        struct Location
+        {
+            ArchiveId archive_id;
+            std::uintmax_t offset;
+            std::uintmax_t size;
+            size_t digests_begin;
+            size_t digests_count;
+        };
+
+        static constexpr size_t max_batch_size = 64;
+        static constexpr size_t max_batch_bytes = 4 * 1024 * 1024;
+
+        std::vector<std::string> m_archive_paths;
+        std::unordered_map<PathStore::FileId, Location> m_locations;
+        std::vector<hashing::Digest> m_digests;
+    };
+}
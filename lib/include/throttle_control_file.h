@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../include/io_throttle.h"
+
+namespace bayan
+{
+    /**
+     * @brief Applies I/O limits from a control file to a throttle, while the instance is alive.
+     *
+     * The file is polled on a background thread and applied, when its modification time changes.
+     * It consists of 'key=value' lines with keys 'bytes_per_second', 'reads_per_second' and
+     * 'metadata_ops_per_second'. Absent keys keep current limits, unknown keys are ignored.
+     */
+    class ThrottleControlFile final
+    {
+    public:
+        /**
+         * @brief Creates instance of @link ThrottleControlFile::ThrottleControlFile @endlink and starts polling.
+         *
+         * @param file_path path to the control file. It may be created later.
+         *
+         * @param throttle throttle to be controlled.
+         *
+         * @param interval interval of polling.
+         */
+        ThrottleControlFile(std::string file_path, std::shared_ptr<IoThrottle> throttle,
+            std::chrono::milliseconds interval = std::chrono::seconds(1));
+
+        ThrottleControlFile(const ThrottleControlFile&) = delete;
+
+        /**
+         * @brief Stops polling.
+         */
+        ~ThrottleControlFile();
+
+        /**
+         * @brief Applies the control file, if it was changed since the last call.
+         *
+         * @return true, if limits were applied.
+         */
+        bool poll();
+
+        ThrottleControlFile& operator =(const ThrottleControlFile&) = delete;
+
+        /**
+         * @brief Parses limits from control file content.
+         *
+         * @param content control file content.
+         *
+         * @param limits current limits, which are updated by present keys.
+         */
+        static void parse(const std::string& content, ThrottleLimits& limits);
+
+    private:
+        std::string m_file_path;
+        std::shared_ptr<IoThrottle> m_throttle;
+        std::chrono::milliseconds m_interval;
+        std::filesystem::file_time_type m_last_write_time;
+        std::mutex m_poll_mutex;
+        std::mutex m_mutex;
+        std::condition_variable m_stop_condition;
+        bool m_is_stop_requested;
+        std::thread m_thread;
+    };
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace bayan
+{
+    /**
+     * @brief Records spans of a search run into per-thread ring buffers and exports them
+     * in Chrome trace-event format, e.g. to be viewed in Perfetto.
+     *
+     * Each thread writes only to its own ring without locks, a lock is taken only when a thread
+     * writes its first span. When tracing is disabled, a span costs one atomic load.
+     */
+    class Tracer final
+    {
+    public:
+        /**
+         * @brief Starts recording spans. Previously recorded spans are discarded.
+         *
+         * @param ring_capacity count of the latest spans, kept per thread.
+         */
+        static void enable(size_t ring_capacity = 65536);
+
+        /**
+         * @brief Stops recording spans. Recorded spans are kept for export.
+         */
+        static void disable() noexcept;
+
+        /**
+         * @brief Checks whether spans are recorded.
+         */
+        [[nodiscard]] static bool is_enabled() noexcept;
+
+        /**
+         * @brief Writes recorded spans in Chrome trace-event JSON format.
+         * Threads must not record spans during export.
+         *
+         * @param output destination stream.
+         */
+        static void write_chrome_trace(std::ostream& output);
+
+        /**
+         * @brief Writes recorded spans in Chrome trace-event JSON format to the file.
+         *
+         * @param file_path path to the trace file.
+         */
+        static void write_chrome_trace(const std::string& file_path);
+    };
+
+    /**
+     * @brief Records a span from its creation to its destruction, if tracing is enabled.
+     */
+    class TraceSpan final
+    {
+    public:
+        /**
+         * @brief Starts the span.
+         *
+         * @param category span category. It must be a string literal.
+         *
+         * @param name span name. It must be a string literal.
+         *
+         * @param argument numeric argument of the span, e.g. a size.
+         */
+        TraceSpan(const char* category, const char* name, std::uint64_t argument = 0) noexcept;
+
+        TraceSpan(const TraceSpan&) = delete;
+
+        /**
+         * @brief Finishes the span.
+         */
+        ~TraceSpan();
+
+        /**
+         * @brief Sets numeric argument of the span, when it is known only at the end.
+         *
+         * @param argument numeric argument.
+         */
+        void set_argument(std::uint64_t argument) noexcept;
+
+        TraceSpan& operator =(const TraceSpan&) = delete;
+
+    private:
+        const char* m_category;
+        const char* m_name;
+        std::uint64_t m_argument;
+        std::uint64_t m_start;
+    };
+}
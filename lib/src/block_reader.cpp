@@ -0,0 +1,237 @@
+#include "../include/block_reader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+#include <utility>
+
+using namespace bayan;
+
+/**
+ * @brief Opens file for reading.
+ *
+ * @param file_path path to file.
+ */
+StreamBlockReader::StreamBlockReader(const std::string& file_path)
+    : m_fs{file_path, std::ios::binary}
+{
+    if (!m_fs.is_open())
+    {
+        throw std::runtime_error("Can't open file: '" + file_path + '\'' + '\n');
+    }
+}
+
+/**
+ * @brief Reads next bytes of file.
+ *
+ * @param buffer destination buffer.
+ *
+ * @param size count of bytes to read.
+ *
+ * @return count of read bytes. It is less than requested at the end of file.
+ */
+size_t StreamBlockReader::read(char* buffer, size_t size)
+{
+    m_fs.read(buffer, size);
+    return m_fs.gcount();
+}
+
+/**
+ * @brief Skips next bytes of file without reading them.
+ *
+ * @param size count of bytes to skip.
+ */
+void StreamBlockReader::skip(std::uintmax_t size)
+{
+    m_fs.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+}
+
+/**
+ * @brief Finds the first offset of data at or after the offset. A stream has no holes, so it is the offset itself.
+ *
+ * @param offset offset in file.
+ *
+ * @return offset of data.
+ */
+std::uintmax_t StreamBlockReader::find_data(std::uintmax_t offset) const
+{
+    return offset;
+}
+
+/**
+ * @brief Finds the first offset of a hole at or after the offset. A stream has no holes, so it is never found.
+ *
+ * @param offset offset of data in file.
+ *
+ * @return @link no_data_offset @endlink.
+ */
+std::uintmax_t StreamBlockReader::find_hole(std::uintmax_t) const
+{
+    return no_data_offset;
+}
+
+/**
+ * @brief Closes file.
+ */
+void StreamBlockReader::close() noexcept
+{
+    m_fs.close();
+}
+
+/**
+ * @brief Checks whether file is open.
+ */
+bool StreamBlockReader::is_open() const noexcept
+{
+    return m_fs.is_open();
+}
+
+/**
+ * @brief Opens file for sequential reading.
+ *
+ * @param file_path path to file.
+ */
+PosixBlockReader::PosixBlockReader(const std::string& file_path)
+    : m_fd{::open(file_path.c_str(), O_RDONLY | O_CLOEXEC)},
+    m_offset{0}
+{
+    if (m_fd < 0)
+    {
+        throw std::runtime_error("Can't open file: '" + file_path + '\'' + '\n');
+    }
+    ::posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+/**
+ * @brief PosixBlockReader move ctor.
+ */
+PosixBlockReader::PosixBlockReader(PosixBlockReader&& other) noexcept
+    : m_fd{std::exchange(other.m_fd, -1)},
+    m_offset{other.m_offset}
+{}
+
+PosixBlockReader::~PosixBlockReader()
+{
+    close();
+}
+
+/**
+ * @brief Reads next bytes of file.
+ *
+ * @param buffer destination buffer.
+ *
+ * @param size count of bytes to read.
+ *
+ * @return count of read bytes. It is less than requested at the end of file.
+ */
+size_t PosixBlockReader::read(char* buffer, size_t size)
+{
+    size_t total = 0;
+    while (total < size)
+    {
+        // Reads are positioned, so hole lookups don't move the read position.
+        auto count = ::pread(m_fd, buffer + total, size - total, static_cast<off_t>(m_offset + total));
+        if (count == 0)
+        {
+            break;
+        }
+        if (count < 0)
+        {
+            if (errno == EINTR) { continue; }
+            throw std::runtime_error(std::string("Can't read file: ") + std::strerror(errno));
+        }
+        total += count;
+    }
+    m_offset += total;
+    return total;
+}
+
+/**
+ * @brief Skips next bytes of file without reading them.
+ *
+ * @param size count of bytes to skip.
+ */
+void PosixBlockReader::skip(std::uintmax_t size)
+{
+    m_offset += size;
+}
+
+/**
+ * @brief Finds the first offset of data at or after the offset, so preceding bytes belong to a hole of a sparse file.
+ *
+ * @param offset offset in file.
+ *
+ * @return offset of data or @link no_data_offset @endlink, if only a hole follows.
+ */
+std::uintmax_t PosixBlockReader::find_data(std::uintmax_t offset) const
+{
+#ifdef SEEK_DATA
+    const auto result = ::lseek(m_fd, static_cast<off_t>(offset), SEEK_DATA);
+    if (result >= 0)
+    {
+        return static_cast<std::uintmax_t>(result);
+    }
+    if (errno == ENXIO)
+    {
+        return no_data_offset;
+    }
+#endif
+    // Without hole support the whole file is data.
+    return offset;
+}
+
+/**
+ * @brief Finds the first offset of a hole at or after the offset. End of file is treated as a hole.
+ *
+ * @param offset offset of data in file.
+ *
+ * @return offset of hole.
+ */
+std::uintmax_t PosixBlockReader::find_hole(std::uintmax_t offset) const
+{
+#ifdef SEEK_HOLE
+    const auto result = ::lseek(m_fd, static_cast<off_t>(offset), SEEK_HOLE);
+    if (result >= 0)
+    {
+        return static_cast<std::uintmax_t>(result);
+    }
+#endif
+    return no_data_offset;
+}
+
+/**
+ * @brief Closes file.
+ */
+void PosixBlockReader::close() noexcept
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+/**
+ * @brief Checks whether file is open.
+ */
+bool PosixBlockReader::is_open() const noexcept
+{
+    return m_fd >= 0;
+}
+
+/**
+ * @brief PosixBlockReader move assignment operator.
+ *
+ * @return reference to assigned instance.
+ */
+PosixBlockReader& PosixBlockReader::operator =(PosixBlockReader&& other) noexcept
+{
+    if (this == &other) { return *this; }
+
+    close();
+    m_fd = std::exchange(other.m_fd, -1);
+    m_offset = other.m_offset;
+    return *this;
+}
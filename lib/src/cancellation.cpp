@@ -0,0 +1,58 @@
+#include "../include/cancellation.h"
+
+using namespace bayan;
+
+OperationCanceledError::OperationCanceledError()
+    : std::runtime_error("Operation was canceled.")
+{}
+
+/**
+ * @brief Checks whether cancellation is requested.
+ */
+bool CancellationToken::is_cancellation_requested() const noexcept
+{
+    return m_is_canceled && m_is_canceled->load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Throws @link OperationCanceledError @endlink, if cancellation is requested.
+ */
+void CancellationToken::throw_if_cancellation_requested() const
+{
+    if (is_cancellation_requested())
+    {
+        throw OperationCanceledError();
+    }
+}
+
+CancellationToken::CancellationToken(std::shared_ptr<const std::atomic<bool>> is_canceled)
+    : m_is_canceled{std::move(is_canceled)}
+{}
+
+CancellationSource::CancellationSource()
+    : m_is_canceled{std::make_shared<std::atomic<bool>>(false)}
+{}
+
+/**
+ * @brief Gets token, bound to the source.
+ */
+CancellationToken CancellationSource::get_token() const
+{
+    return CancellationToken(m_is_canceled);
+}
+
+/**
+ * @brief Requests cancellation of operations, observing tokens of the source.
+ */
+void CancellationSource::cancel() noexcept
+{
+    m_is_canceled->store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Checks whether cancellation is requested.
+ */
+bool CancellationSource::is_cancellation_requested() const noexcept
+{
+    return m_is_canceled->load(std::memory_order_relaxed);
+}
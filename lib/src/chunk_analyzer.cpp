@@ -0,0 +1,309 @@
+#include "../include/chunk_analyzer.h"
+
+#include "../include/block_reader.h"
+#include "../include/digest_group_table.h"
+#include "../include/hashing.h"
+#include "../include/tracing.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+
+using namespace bayan;
+using namespace bayan::hashing;
+
+namespace
+{
+    constexpr size_t min_read_buffer_size = 1024 * 1024;
+
+    /**
+     * @brief Gets gear table of pseudo-random 64-bit values, one per byte value. It is generated by splitmix64,
+     * so cut points are stable between builds.
+     */
+    constexpr std::array<std::uint64_t, 256> make_gear_table() noexcept
+    {
+        std::array<std::uint64_t, 256> table {};
+        std::uint64_t state = 0x2545F4914F6CDD1Dull;
+        for (auto& value : table)
+        {
+            state += 0x9E3779B97F4A7C15ull;
+            auto mixed = state;
+            mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+            value = mixed ^ (mixed >> 31);
+        }
+        return table;
+    }
+
+    constexpr auto gear_table = make_gear_table();
+
+    // The rolling hash is shifted left, so its high bits depend on the most bytes of the window.
+    constexpr std::uint64_t get_high_bits_mask(unsigned bits_count) noexcept
+    {
+        return bits_count == 0 ? 0 : ~std::uint64_t { 0 } << (64 - bits_count);
+    }
+}
+
+/**
+ * @brief Creates instance of @link ContentChunker::ContentChunker @endlink.
+ *
+ * @param options chunking options.
+ */
+ContentChunker::ContentChunker(const ChunkingOptions& options)
+    : m_min_chunk_size{options.min_chunk_size},
+    m_average_chunk_size{std::bit_floor(options.average_chunk_size)},
+    m_max_chunk_size{options.max_chunk_size}
+{
+    if (m_min_chunk_size == 0 || m_average_chunk_size < 2
+        || m_min_chunk_size > m_average_chunk_size || m_average_chunk_size > m_max_chunk_size)
+    {
+        throw std::invalid_argument("Chunk sizes must satisfy 0 < min <= average <= max.");
+    }
+
+    const auto bits_count = static_cast<unsigned>(std::countr_zero(m_average_chunk_size));
+    m_strict_mask = get_high_bits_mask(bits_count + 1);
+    m_loose_mask = get_high_bits_mask(bits_count - 1);
+}
+
+/**
+ * @brief Finds the end of the first chunk of data.
+ *
+ * @param data content bytes.
+ *
+ * @param size count of bytes. If it is less than the maximum chunk size, data must end the content.
+ *
+ * @return chunk size.
+ */
+size_t ContentChunker::find_cut(const char* data, size_t size) const noexcept
+{
+    if (size <= m_min_chunk_size)
+    {
+        return size;
+    }
+
+    const auto end = std::min(size, m_max_chunk_size);
+    const auto normal_end = std::min(end, m_average_chunk_size);
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    std::uint64_t hash = 0;
+    size_t position = m_min_chunk_size;
+    for (; position < normal_end; ++position)
+    {
+        hash = (hash << 1) + gear_table[bytes[position]];
+        if ((hash & m_strict_mask) == 0)
+        {
+            return position + 1;
+        }
+    }
+    for (; position < end; ++position)
+    {
+        hash = (hash << 1) + gear_table[bytes[position]];
+        if ((hash & m_loose_mask) == 0)
+        {
+            return position + 1;
+        }
+    }
+    return end;
+}
+
+/**
+ * @brief Gets maximum chunk size in bytes.
+ */
+size_t ContentChunker::get_max_chunk_size() const noexcept
+{
+    return m_max_chunk_size;
+}
+
+/**
+ * @brief Creates instance of @link ChunkAnalyzer::ChunkAnalyzer @endlink.
+ *
+ * @param options chunking options.
+ *
+ * @param min_file_size_bytes minimum file size in bytes.
+ */
+ChunkAnalyzer::ChunkAnalyzer(const ChunkingOptions& options, size_t min_file_size_bytes)
+    : m_options{options},
+    m_chunker{options},
+    m_min_file_size_bytes{min_file_size_bytes},
+    m_scan_options{},
+    m_cancellation_token{},
+    m_progress_reporter{nullptr}
+{}
+
+/**
+ * @brief Scans directories and reports chunks shared between found files.
+ *
+ * @param dir_paths collection of paths to target directories.
+ *
+ * @param exclude_dirs collection of paths to directories that must be excluded from analysis.
+ *
+ * @param file_mask defines which file names would be analyzed.
+ *
+ * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
+ *
+ * @return chunk report.
+ */
+ChunkReport ChunkAnalyzer::analyze(const std::vector<std::string>& dir_paths, const std::vector<std::string>& exclude_dirs,
+    const std::string& file_mask, bool is_recursive) const
+{
+    TraceSpan span("search", "chunk_analysis");
+    ChunkReport report;
+    auto scan_options = m_scan_options;
+    scan_options.scan_archives = false;
+    scan_options.is_memory_lean = false;
+
+    DirectoryScanner scanner(dir_paths, exclude_dirs, m_min_file_size_bytes);
+    scanner.set_cancellation_token(m_cancellation_token);
+    scanner.set_progress_reporter(m_progress_reporter);
+    scanner.set_scan_options(scan_options);
+    scanner.set_throttle(m_throttle.get());
+    const auto files_by_size = scanner.scan(report.paths, file_mask, is_recursive);
+
+    // Chunk sizes are indexed by group ids of the table, which are assigned in order of appearance.
+    DigestGroupTable chunks;
+    std::vector<std::uint32_t> chunk_sizes;
+    Md5Hasher hasher;
+
+    const auto max_chunk_size = m_chunker.get_max_chunk_size();
+    std::vector<char> buffer(std::max(min_read_buffer_size, 4 * max_chunk_size));
+    for (const auto& [file_size, file_ids] : files_by_size)
+    {
+        for (const auto file_id : file_ids)
+        {
+            TraceSpan file_span("io", "chunk_file", file_size);
+            PosixBlockReader reader(report.paths.get_path(file_id));
+
+            // The window is refilled, when less than a maximum chunk is left, so every cut sees a whole chunk.
+            size_t begin = 0;
+            size_t end = 0;
+            bool is_end_of_file = false;
+            for (;;)
+            {
+                if (!is_end_of_file && end - begin < max_chunk_size)
+                {
+                    std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+                    end -= begin;
+                    begin = 0;
+
+                    m_cancellation_token.throw_if_cancellation_requested();
+                    const auto requested = buffer.size() - end;
+                    if (m_throttle != nullptr)
+                    {
+                        m_throttle->acquire_read(requested, m_cancellation_token);
+                    }
+                    const auto count = reader.read(buffer.data() + end, requested);
+                    end += count;
+                    is_end_of_file = count < requested;
+                    if (m_progress_reporter != nullptr)
+                    {
+                        m_progress_reporter->add_bytes_hashed(count);
+                    }
+                }
+                if (begin == end)
+                {
+                    break;
+                }
+
+                const auto chunk_size = m_chunker.find_cut(buffer.data() + begin, end - begin);
+                const auto chunk_id = chunks.add(hasher(std::string_view(buffer.data() + begin, chunk_size)), file_id);
+                if (chunk_id == chunk_sizes.size())
+                {
+                    chunk_sizes.push_back(static_cast<std::uint32_t>(chunk_size));
+                }
+
+                report.total_bytes += chunk_size;
+                ++report.chunks_count;
+                begin += chunk_size;
+            }
+        }
+    }
+
+    std::vector<PathStore::FileId> members;
+    std::vector<size_t> offsets { 0 };
+    chunks.append_groups(members, offsets, 1);
+
+    std::unordered_map<std::uint64_t, std::uint64_t> shared_bytes_by_pair;
+    for (size_t chunk_id = 0; chunk_id + 1 < offsets.size(); ++chunk_id)
+    {
+        const auto chunk_size = chunk_sizes[chunk_id];
+        report.unique_bytes += chunk_size;
+
+        // Files are chunked one by one, so repeats of a chunk inside a file are adjacent.
+        const auto files_begin = members.begin() + offsets[chunk_id];
+        const auto files_end = std::unique(files_begin, members.begin() + offsets[chunk_id + 1]);
+        const auto files_count = static_cast<size_t>(files_end - files_begin);
+        if (files_count < 2 || files_count > m_options.max_pair_fanout)
+        {
+            continue;
+        }
+
+        for (auto first = files_begin; first != files_end; ++first)
+        {
+            for (auto second = first + 1; second != files_end; ++second)
+            {
+                const auto [low, high] = std::minmax(*first, *second);
+                shared_bytes_by_pair[static_cast<std::uint64_t>(low) << 32 | high] += chunk_size;
+            }
+        }
+    }
+    report.unique_chunks_count = chunk_sizes.size();
+
+    report.pairs.reserve(shared_bytes_by_pair.size());
+    for (const auto& [key, shared_bytes] : shared_bytes_by_pair)
+    {
+        report.pairs.push_back({ static_cast<PathStore::FileId>(key >> 32), static_cast<PathStore::FileId>(key), shared_bytes });
+    }
+    std::sort(report.pairs.begin(), report.pairs.end(), [](const auto& left, const auto& right)
+    {
+        return left.shared_bytes != right.shared_bytes
+            ? left.shared_bytes > right.shared_bytes
+            : std::tie(left.first, left.second) < std::tie(right.first, right.second);
+    });
+    return report;
+}
+
+/**
+ * @brief Sets options of directory scanning. Archives are analyzed as files, since their members can't be read as files.
+ * Memory lean scanning is off, since files of unique sizes still share chunks.
+ *
+ * @param scan_options scan options.
+ */
+void ChunkAnalyzer::set_scan_options(const ScanOptions& scan_options) noexcept
+{
+    m_scan_options = scan_options;
+}
+
+/**
+ * @brief Sets token, which stops analysis with @link OperationCanceledError @endlink, when canceled.
+ *
+ * @param cancellation_token cancellation token.
+ */
+void ChunkAnalyzer::set_cancellation_token(const CancellationToken& cancellation_token)
+{
+    m_cancellation_token = cancellation_token;
+}
+
+/**
+ * @brief Sets reporter of scanned files and chunked bytes.
+ *
+ * @param progress_reporter progress reporter, which outlives the analysis, or nullptr.
+ */
+void ChunkAnalyzer::set_progress_reporter(ProgressReporter* progress_reporter) noexcept
+{
+    m_progress_reporter = progress_reporter;
+}
+
+/**
+ * @brief Sets throttle of file reads and metadata operations.
+ *
+ * @param throttle I/O throttle or nullptr.
+ */
+void ChunkAnalyzer::set_throttle(std::shared_ptr<IoThrottle> throttle) noexcept
+{
+    m_throttle = std::move(throttle);
+}
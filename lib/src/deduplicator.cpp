@@ -0,0 +1,328 @@
+#include "../include/deduplicator.h"
+
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace bayan;
+
+namespace
+{
+    // btrfs shares at most 16 MiB per request, larger ranges are split.
+    constexpr std::uint64_t max_dedupe_length = 16 * 1024 * 1024;
+
+    // The request with its destinations must fit into a page.
+    constexpr size_t max_destinations_per_request =
+        (4096 - sizeof(file_dedupe_range)) / sizeof(file_dedupe_range_info);
+
+    constexpr size_t compare_buffer_size = 64 * 1024;
+
+    class FileDescriptor final
+    {
+    public:
+        FileDescriptor() noexcept = default;
+        explicit FileDescriptor(int fd) noexcept : m_fd{fd} {}
+
+        FileDescriptor(const FileDescriptor&) = delete;
+        FileDescriptor(FileDescriptor&& other) noexcept : m_fd{other.m_fd} { other.m_fd = -1; }
+
+        ~FileDescriptor()
+        {
+            if (m_fd >= 0) { ::close(m_fd); }
+        }
+
+        FileDescriptor& operator =(const FileDescriptor&) = delete;
+        FileDescriptor& operator =(FileDescriptor&& other) noexcept
+        {
+            std::swap(m_fd, other.m_fd);
+            return *this;
+        }
+
+        [[nodiscard]] int get() const noexcept { return m_fd; }
+
+        [[nodiscard]] bool is_open() const noexcept { return m_fd >= 0; }
+
+    private:
+        int m_fd = -1;
+    };
+
+    enum class CloneStatus
+    {
+        Pending,
+        Cloned,
+        Differs,
+        Unsupported,
+        Failed
+    };
+
+    struct Destination
+    {
+        std::string path;
+        FileDescriptor fd {};
+        CloneStatus status = CloneStatus::Pending;
+        int error = 0;
+    };
+
+    bool is_unsupported_error(int error) noexcept
+    {
+        return error == EOPNOTSUPP || error == ENOTSUP || error == ENOTTY || error == EINVAL || error == EXDEV;
+    }
+
+    void set_error(Destination& destination, int error) noexcept
+    {
+        destination.status = is_unsupported_error(error) ? CloneStatus::Unsupported : CloneStatus::Failed;
+        destination.error = error;
+    }
+
+    FileDescriptor open_destination(const std::string& path)
+    {
+        // Owners may share extents of files, opened only for reading.
+        FileDescriptor fd(::open(path.c_str(), O_RDWR | O_CLOEXEC));
+        if (!fd.is_open() && (errno == EACCES || errno == EPERM || errno == EROFS || errno == ETXTBSY))
+        {
+            fd = FileDescriptor(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        }
+        return fd;
+    }
+
+    void clone_destinations(int source_fd, std::uint64_t file_size, std::vector<Destination>& destinations)
+    {
+        std::vector<std::uint8_t> request_buffer(sizeof(file_dedupe_range) + max_destinations_per_request * sizeof(file_dedupe_range_info));
+        auto* request = reinterpret_cast<file_dedupe_range*>(request_buffer.data());
+        std::vector<Destination*> batch;
+        batch.reserve(max_destinations_per_request);
+
+        for (std::uint64_t offset = 0; offset < file_size; offset += max_dedupe_length)
+        {
+            const auto length = std::min(max_dedupe_length, file_size - offset);
+
+            auto iter = destinations.begin();
+            while (iter != destinations.end())
+            {
+                batch.clear();
+                for (; iter != destinations.end() && batch.size() < max_destinations_per_request; ++iter)
+                {
+                    if (iter->status == CloneStatus::Pending) { batch.push_back(&*iter); }
+                }
+                if (batch.empty()) { break; }
+
+                std::fill(request_buffer.begin(), request_buffer.end(), 0);
+                request->src_offset = offset;
+                request->src_length = length;
+                request->dest_count = static_cast<std::uint16_t>(batch.size());
+                for (size_t i = 0; i < batch.size(); ++i)
+                {
+                    request->info[i].dest_fd = batch[i]->fd.get();
+                    request->info[i].dest_offset = offset;
+                }
+
+                if (::ioctl(source_fd, FIDEDUPERANGE, request) < 0)
+                {
+                    const int error = errno;
+                    for (auto* destination : batch) { set_error(*destination, error); }
+                    continue;
+                }
+
+                for (size_t i = 0; i < batch.size(); ++i)
+                {
+                    const auto& info = request->info[i];
+                    if (info.status < 0)
+                    {
+                        set_error(*batch[i], -info.status);
+                    }
+                    else if (info.status == FILE_DEDUPE_RANGE_DIFFERS)
+                    {
+                        batch[i]->status = CloneStatus::Differs;
+                    }
+                    else if (info.bytes_deduped != length)
+                    {
+                        batch[i]->status = CloneStatus::Failed;
+                        batch[i]->error = EIO;
+                    }
+                }
+            }
+        }
+
+        for (auto& destination : destinations)
+        {
+            if (destination.status == CloneStatus::Pending) { destination.status = CloneStatus::Cloned; }
+        }
+    }
+}
+
+/**
+ * @brief Creates instance of @link Deduplicator::Deduplicator @endlink.
+ *
+ * @param options action options.
+ */
+Deduplicator::Deduplicator(const DeduplicationOptions& options)
+    : m_options{options}
+{}
+
+/**
+ * @brief Deduplicates each group against its first file. Archive members are skipped.
+ *
+ * @param duplicates grouped duplicates.
+ *
+ * @return action report.
+ */
+DeduplicationReport Deduplicator::deduplicate(const DuplicateGroups& duplicates) const
+{
+    DeduplicationReport report;
+    for (size_t i = 0; i < duplicates.size(); ++i)
+    {
+        deduplicate_group(duplicates, duplicates[i], report);
+    }
+    return report;
+}
+
+void Deduplicator::deduplicate_group(const DuplicateGroups& duplicates, DuplicateGroups::Group group, DeduplicationReport& report) const
+{
+    // Archive members have no files on disk, so they are neither sources nor destinations.
+    std::vector<PathStore::FileId> file_ids;
+    file_ids.reserve(group.size());
+    std::copy_if(group.begin(), group.end(), std::back_inserter(file_ids),
+        [&duplicates](PathStore::FileId file_id) { return !duplicates.is_archive_member(file_id); });
+    if (file_ids.size() < 2)
+    {
+        return;
+    }
+
+    const auto source_path = duplicates.get_path(file_ids.front());
+    FileDescriptor source_fd(::open(source_path.c_str(), O_RDONLY | O_CLOEXEC));
+    struct stat source_stat {};
+    if (!source_fd.is_open() || ::fstat(source_fd.get(), &source_stat) != 0)
+    {
+        report.files_failed += file_ids.size() - 1;
+        report.errors.push_back("Can't open file: '" + source_path + "': " + std::strerror(errno));
+        return;
+    }
+
+    const auto file_size = static_cast<std::uint64_t>(source_stat.st_size);
+    std::vector<Destination> destinations;
+    destinations.reserve(file_ids.size() - 1);
+    for (const auto file_id : std::span(file_ids).subspan(1))
+    {
+        Destination destination { duplicates.get_path(file_id) };
+
+        struct stat destination_stat {};
+        if (::stat(destination.path.c_str(), &destination_stat) == 0
+            && destination_stat.st_dev == source_stat.st_dev && destination_stat.st_ino == source_stat.st_ino)
+        {
+            // Already a hard link to the source.
+            continue;
+        }
+
+        if (m_options.dry_run)
+        {
+            ++report.files_deduplicated;
+            report.bytes_deduplicated += file_size;
+            continue;
+        }
+
+        destination.fd = open_destination(destination.path);
+        if (!destination.fd.is_open())
+        {
+            destination.status = CloneStatus::Failed;
+            destination.error = errno;
+        }
+        destinations.push_back(std::move(destination));
+    }
+
+    clone_destinations(source_fd.get(), file_size, destinations);
+
+    for (auto& destination : destinations)
+    {
+        destination.fd = FileDescriptor();
+
+        if (destination.status == CloneStatus::Unsupported && m_options.hardlink_fallback)
+        {
+            // Unlike the kernel dedupe, linking doesn't compare bytes, so verify them first.
+            try
+            {
+                if (is_content_equal(source_path, destination.path))
+                {
+                    link_file(source_path, destination.path);
+                    ++report.files_linked;
+                    ++report.files_deduplicated;
+                    report.bytes_deduplicated += file_size;
+                    continue;
+                }
+                destination.status = CloneStatus::Differs;
+            }
+            catch (const std::exception& ex)
+            {
+                ++report.files_failed;
+                report.errors.push_back("Can't link file: '" + destination.path + "': " + ex.what());
+                continue;
+            }
+        }
+
+        switch (destination.status)
+        {
+            case CloneStatus::Cloned:
+                ++report.files_cloned;
+                ++report.files_deduplicated;
+                report.bytes_deduplicated += file_size;
+                break;
+
+            case CloneStatus::Differs:
+                ++report.files_failed;
+                report.errors.push_back("Content differs from '" + source_path + "': '" + destination.path + '\'');
+                break;
+
+            default:
+                ++report.files_failed;
+                report.errors.push_back("Can't deduplicate file: '" + destination.path + "': " + std::strerror(destination.error));
+                break;
+        }
+    }
+}
+
+bool Deduplicator::is_content_equal(const std::string& source_path, const std::string& destination_path)
+{
+    std::ifstream source(source_path, std::ios::binary);
+    std::ifstream destination(destination_path, std::ios::binary);
+    if (!source.is_open() || !destination.is_open())
+    {
+        throw std::runtime_error("Can't open file for comparison.");
+    }
+
+    std::vector<char> source_buffer(compare_buffer_size);
+    std::vector<char> destination_buffer(compare_buffer_size);
+    while (source && destination)
+    {
+        source.read(source_buffer.data(), source_buffer.size());
+        destination.read(destination_buffer.data(), destination_buffer.size());
+        if (source.gcount() != destination.gcount()
+            || std::memcmp(source_buffer.data(), destination_buffer.data(), source.gcount()) != 0)
+        {
+            return false;
+        }
+    }
+    return source.eof() && destination.eof();
+}
+
+void Deduplicator::link_file(const std::string& source_path, const std::string& destination_path)
+{
+    const boost::filesystem::path temporary_path(destination_path + ".bayan-link");
+    boost::filesystem::create_hard_link(source_path, temporary_path);
+    try
+    {
+        boost::filesystem::rename(temporary_path, destination_path);
+    }
+    catch (...)
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(temporary_path, ec);
+        throw;
+    }
+}
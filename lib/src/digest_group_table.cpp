@@ -0,0 +1,186 @@
+#include "../include/digest_group_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace bayan;
+
+namespace
+{
+    constexpr size_t initial_capacity = 16;
+
+    size_t get_digest_hash(const hashing::Digest& digest) noexcept
+    {
+        std::uint64_t low;
+        std::uint64_t high;
+        std::memcpy(&low, digest.bytes.data(), sizeof(low));
+        std::memcpy(&high, digest.bytes.data() + sizeof(low), sizeof(high));
+
+        auto hash = (low ^ (high * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+        return static_cast<size_t>(hash ^ (hash >> 31));
+    }
+}
+
+/**
+ * @brief Adds file to the group of the digest. Creates the group, if it is absent.
+ *
+ * @param digest content digest of the file.
+ *
+ * @param file_id file identifier.
+ *
+ * @return identifier of the group the file was added to.
+ */
+DigestGroupTable::GroupId DigestGroupTable::add(const hashing::Digest& digest, PathStore::FileId file_id)
+{
+    if ((m_group_digests.size() + 1) * 2 > m_slots.size())
+    {
+        grow();
+    }
+
+    const auto slot_index = find_slot(digest);
+    auto& slot = m_slots[slot_index];
+    if (slot.group_id == no_group)
+    {
+        if (m_group_digests.size() >= no_group)
+        {
+            throw std::length_error("Too many digest groups.");
+        }
+
+        slot.digest = digest;
+        slot.group_id = static_cast<GroupId>(m_group_digests.size());
+        m_group_slots.push_back(slot_index);
+        m_group_digests.push_back(digest);
+        m_group_sizes.push_back(0);
+    }
+
+    ++m_group_sizes[slot.group_id];
+    m_member_groups.push_back(slot.group_id);
+    m_member_files.push_back(file_id);
+    return slot.group_id;
+}
+
+/**
+ * @brief Finds the group of the digest.
+ *
+ * @param digest content digest.
+ *
+ * @return group identifier or @link DigestGroupTable::no_group @endlink.
+ */
+DigestGroupTable::GroupId DigestGroupTable::find(const hashing::Digest& digest) const noexcept
+{
+    if (m_slots.empty())
+    {
+        return no_group;
+    }
+    return m_slots[find_slot(digest)].group_id;
+}
+
+/**
+ * @brief Gets count of groups.
+ */
+size_t DigestGroupTable::groups_count() const noexcept
+{
+    return m_group_digests.size();
+}
+
+/**
+ * @brief Gets count of members in the group.
+ *
+ * @param group_id group identifier.
+ */
+size_t DigestGroupTable::group_size(GroupId group_id) const
+{
+    return m_group_sizes.at(group_id);
+}
+
+/**
+ * @brief Gets digest of the group.
+ *
+ * @param group_id group identifier.
+ */
+const hashing::Digest& DigestGroupTable::group_digest(GroupId group_id) const
+{
+    return m_group_digests.at(group_id);
+}
+
+/**
+ * @brief Appends groups to a flat members array, where each group is delimited by offsets.
+ *
+ * @param members flat array of file ids.
+ *
+ * @param offsets offsets of groups in the members array. It must start with 0.
+ *
+ * @param min_group_size groups with less members are skipped.
+ */
+void DigestGroupTable::append_groups(std::vector<PathStore::FileId>& members, std::vector<size_t>& offsets, size_t min_group_size) const
+{
+    m_write_positions.assign(m_group_sizes.size(), 0);
+
+    auto position = members.size();
+    for (size_t group_id = 0; group_id < m_group_sizes.size(); ++group_id)
+    {
+        if (m_group_sizes[group_id] < min_group_size)
+        {
+            continue;
+        }
+
+        m_write_positions[group_id] = position;
+        position += m_group_sizes[group_id];
+        offsets.push_back(position);
+    }
+
+    members.resize(position);
+    for (size_t i = 0; i < m_member_files.size(); ++i)
+    {
+        const auto group_id = m_member_groups[i];
+        if (m_group_sizes[group_id] < min_group_size)
+        {
+            continue;
+        }
+        members[m_write_positions[group_id]++] = m_member_files[i];
+    }
+}
+
+/**
+ * @brief Removes all groups. Allocated memory is kept.
+ */
+void DigestGroupTable::clear() noexcept
+{
+    for (const auto slot_index : m_group_slots)
+    {
+        m_slots[slot_index].group_id = no_group;
+    }
+    m_group_slots.clear();
+    m_group_digests.clear();
+    m_group_sizes.clear();
+    m_member_groups.clear();
+    m_member_files.clear();
+}
+
+size_t DigestGroupTable::find_slot(const hashing::Digest& digest) const noexcept
+{
+    const auto mask = m_slots.size() - 1;
+    auto index = get_digest_hash(digest) & mask;
+    while (m_slots[index].group_id != no_group && m_slots[index].digest != digest)
+    {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+void DigestGroupTable::grow()
+{
+    auto old_slots = std::move(m_slots);
+    m_slots.assign(std::max(initial_capacity, old_slots.size() * 2), Slot{});
+
+    for (const auto& slot : old_slots)
+    {
+        if (slot.group_id != no_group)
+        {
+            const auto slot_index = find_slot(slot.digest);
+            m_slots[slot_index] = slot;
+            m_group_slots[slot.group_id] = slot_index;
+        }
+    }
+}
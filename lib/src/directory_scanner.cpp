@@ -1,10 +1,72 @@
 #include "../include/directory_scanner.h"
 
+#include "../include/size_count_sketch.h"
+#include "../include/tracing.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
 #include <iostream>
 #include <p_glob.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#endif
 
 using namespace bayan;
 
+namespace
+{
+    constexpr size_t directory_entries_buffer_size = 256 * 1024;
+
+    class DirectoryDescriptor final
+    {
+    public:
+        explicit DirectoryDescriptor(int fd) noexcept : m_fd{fd} {}
+
+        DirectoryDescriptor(const DirectoryDescriptor&) = delete;
+
+        ~DirectoryDescriptor()
+        {
+            if (m_fd >= 0) { ::close(m_fd); }
+        }
+
+        DirectoryDescriptor& operator =(const DirectoryDescriptor&) = delete;
+
+        [[nodiscard]] int get() const noexcept { return m_fd; }
+
+    private:
+        int m_fd;
+    };
+
+    std::string join_path(const std::string& dir_path, const std::string& name)
+    {
+        return !dir_path.empty() && dir_path.back() == '/' ? dir_path + name : dir_path + '/' + name;
+    }
+
+    /**
+     * @brief Gets components of the canonical path after its canonical ancestor.
+     *
+     * @return true, if the path lies inside the ancestor or is equal to it.
+     */
+    bool try_get_relative_components(const boost::filesystem::path& path, const boost::filesystem::path& ancestor,
+        std::vector<boost::filesystem::path>& components)
+    {
+        const auto [ancestor_end, path_begin] = std::mismatch(ancestor.begin(), ancestor.end(), path.begin(), path.end());
+        if (ancestor_end != ancestor.end())
+        {
+            return false;
+        }
+        components.assign(path_begin, path.end());
+        return true;
+    }
+}
+
 /**
  * @brief Creates instance of @link DirectoryScanner::DirectoryScanner @endlink.
  *
@@ -18,26 +80,64 @@ DirectoryScanner::DirectoryScanner(const std::vector<std::string>& dir_paths,
     const std::vector<std::string>& exclude_dirs, size_t min_file_size_bytes)
     : m_dir_paths{dir_paths},
       m_exclude_dirs{exclude_dirs},
-      m_min_file_size_bytes{min_file_size_bytes}
+      m_min_file_size_bytes{min_file_size_bytes},
+      m_cancellation_token{},
+      m_progress_reporter{nullptr},
+      m_options{},
+      m_throttle{nullptr}
 {}
 
 /**
- * @brief Scans directories and returns collection of found file paths, groupded by file size.
+ * @brief Scans directories and returns collection of found file ids, groupded by file size.
+ * In memory lean mode only sizes of at least two files are returned.
+ *
+ * @param path_store storage, where paths of found files are interned.
  *
  * @param file_mask defines which file names would be included into search.
  *
  * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
  *
- * @return file paths, grouped by file size.
+ * @return file ids, grouped by file size.
  */
-DirectoryScanner::GroupedBySizeMap DirectoryScanner::scan(const std::string& file_mask, bool is_recursive)
+DirectoryScanner::GroupedBySizeMap DirectoryScanner::scan(PathStore& path_store, const std::string& file_mask, bool is_recursive)
 {
+    TraceSpan span("scan", "scan");
     try
     {
-        auto file_mask_regex = pglob::compile_pattern(file_mask);
-        return is_recursive
-            ? recursive_scan(std::move(file_mask_regex))
-            : top_level_scan(std::move(file_mask_regex));
+        const auto file_mask_regex = pglob::compile_pattern(file_mask);
+        m_archive_members = ArchiveMembers();
+        m_archive_headers.clear();
+
+        GroupedBySizeMap groups;
+        if (!m_options.is_memory_lean)
+        {
+            walk(&path_store, file_mask_regex, is_recursive, [&](size_t size, PathStore::DirectoryId dir_id, const std::string& file_name)
+            {
+                groups[size].push_back(path_store.add_file(dir_id, file_name));
+            });
+            return groups;
+        }
+
+        // The first pass stores nothing but counters, so paths of unique sizes are never kept.
+        // Archive headers, read by it, are kept for the second pass.
+        SizeCountSketch sketch(m_options.sketch_size_log2);
+        walk(nullptr, file_mask_regex, is_recursive, [&sketch](size_t size, PathStore::DirectoryId, const std::string&)
+        {
+            sketch.add(size);
+        });
+
+        walk(&path_store, file_mask_regex, is_recursive, [&](size_t size, PathStore::DirectoryId dir_id, const std::string& file_name)
+        {
+            if (sketch.may_be_repeated(size))
+            {
+                groups[size].push_back(path_store.add_file(dir_id, file_name));
+            }
+        });
+        m_archive_headers.clear();
+
+        // Sizes, which collided in the sketch, are confirmed exactly.
+        std::erase_if(groups, [](const auto& group) { return group.second.size() < 2; });
+        return groups;
     }
     catch(const filesystem_error& fex)
     {
@@ -46,81 +146,206 @@ DirectoryScanner::GroupedBySizeMap DirectoryScanner::scan(const std::string& fil
     }
 }
 
-DirectoryScanner::GroupedBySizeMap DirectoryScanner::recursive_scan(std::regex&& file_mask_regex)
+/**
+ * @brief Sets token, which stops scanning with @link OperationCanceledError @endlink, when canceled.
+ *
+ * @param cancellation_token cancellation token.
+ */
+void DirectoryScanner::set_cancellation_token(const CancellationToken& cancellation_token)
 {
-    GroupedBySizeMap groups;
-    for (const auto& dir_path : m_dir_paths)
+    m_cancellation_token = cancellation_token;
+}
+
+/**
+ * @brief Sets reporter of visited files. The reporter must outlive scanning.
+ *
+ * @param progress_reporter progress reporter or nullptr.
+ */
+void DirectoryScanner::set_progress_reporter(ProgressReporter* progress_reporter) noexcept
+{
+    m_progress_reporter = progress_reporter;
+}
+
+/**
+ * @brief Sets options of scanning.
+ *
+ * @param options scan options.
+ */
+void DirectoryScanner::set_scan_options(const ScanOptions& options) noexcept
+{
+    m_options = options;
+}
+
+/**
+ * @brief Sets throttle of metadata operations. The throttle must outlive scanning.
+ *
+ * @param throttle I/O throttle or nullptr.
+ */
+void DirectoryScanner::set_throttle(IoThrottle* throttle) noexcept
+{
+    m_throttle = throttle;
+}
+
+/**
+ * @brief Moves out archive members, found by the last scan. The scanner is left with no members.
+ */
+ArchiveMembers DirectoryScanner::take_archive_members() noexcept
+{
+    return std::exchange(m_archive_members, ArchiveMembers());
+}
+
+void DirectoryScanner::throttle_metadata()
+{
+    if (m_throttle != nullptr)
+    {
+        m_throttle->acquire_metadata(m_cancellation_token);
+    }
+}
+
+void DirectoryScanner::walk(PathStore* path_store, const std::regex& file_mask_regex, bool is_recursive, const FileHandler& on_file)
+{
+    TraceSpan span("scan", "walk");
+    m_visited.clear();
+#ifdef __linux__
+    if (m_options.walker == WalkerType::Native)
     {
+        native_scan(path_store, file_mask_regex, is_recursive, on_file);
+        return;
+    }
+#endif
+
+    if (is_recursive)
+    {
+        recursive_scan(path_store, file_mask_regex, on_file);
+    }
+    else
+    {
+        top_level_scan(path_store, file_mask_regex, on_file);
+    }
+}
+
+void DirectoryScanner::recursive_scan(PathStore* path_store, const std::regex& file_mask_regex, const FileHandler& on_file)
+{
+    // Without a path store only files are visited, e.g. to count sizes.
+    auto add_directory = [path_store](PathStore::DirectoryId parent, const std::string& name)
+    {
+        return path_store ? path_store->add_directory(parent, name) : PathStore::no_directory;
+    };
+
+    for (const auto& dir_path : get_root_paths(true))
+    {
+        TraceSpan span("scan", "directory");
         if (!exists(dir_path) || !is_directory(dir_path))
         {
             throw std::runtime_error("'" + dir_path + "'" + " is not a directory.");
         }
 
-        recursive_directory_iterator dir_iterator(dir_path);
-        for (const auto& fs_item : dir_iterator)
+        if (!try_visit(dir_path))
         {
-            auto path = fs_item.path();
+            continue;
+        }
+
+        // Directory ids of the current iterator branch, indexed by depth.
+        std::vector<PathStore::DirectoryId> dir_ids { add_directory(PathStore::no_directory, dir_path) };
+
+        recursive_directory_iterator dir_iterator(dir_path, m_options.follow_symlinks
+            ? directory_options::follow_directory_symlink
+            : directory_options::none);
+        for (auto end = recursive_directory_iterator(); dir_iterator != end; ++dir_iterator)
+        {
+            m_cancellation_token.throw_if_cancellation_requested();
+            throttle_metadata();
+
+            const auto& path = dir_iterator->path();
+            dir_ids.resize(dir_iterator.depth() + 1);
 
             if (is_directory(path))
             {
-                auto exclude_dirs_end = m_exclude_dirs.end();
-                if (auto it = std::find(m_exclude_dirs.begin(), exclude_dirs_end, path.string()); it != exclude_dirs_end)
+                if (is_excluded(path.string()))
                 {
                     dir_iterator.disable_recursion_pending();
+                    continue;
                 }
+
+                if (!try_visit(path))
+                {
+                    dir_iterator.disable_recursion_pending();
+                    continue;
+                }
+
+                dir_ids.push_back(add_directory(dir_ids.back(), path.filename().string()));
                 continue;
             }
 
             if (is_regular_file(path))
             {
-                handle_file(path, file_mask_regex, groups);
+                handle_file(path, dir_ids.back(), file_mask_regex, path_store, on_file);
                 continue;
             }
 
-            if (is_symlink(path))
-            {
-                // TODO: handle symlinks
-            }
+            // Links are resolved by the checks above, so broken links and links to special files are skipped.
         }
     }
-    return groups;
 }
 
-DirectoryScanner::GroupedBySizeMap DirectoryScanner::top_level_scan(std::regex&& file_mask_regex)
+void DirectoryScanner::top_level_scan(PathStore* path_store, const std::regex& file_mask_regex, const FileHandler& on_file)
 {
-    GroupedBySizeMap groups;
-    for (const auto& dir_path : m_dir_paths)
+    for (const auto& dir_path : get_root_paths(false))
     {
+        TraceSpan span("scan", "directory");
         if (!exists(dir_path) || !is_directory(dir_path))
         {
             throw std::runtime_error("'" + dir_path + "'" + " is not a directory.");
         }
 
+        auto dir_id = path_store ? path_store->add_directory(PathStore::no_directory, dir_path) : PathStore::no_directory;
+
         directory_iterator dir_iterator(dir_path);
         for (const auto& fs_item : dir_iterator)
         {
+            m_cancellation_token.throw_if_cancellation_requested();
+            throttle_metadata();
+
             auto path = fs_item.path();
 
             if (is_regular_file(path))
             {
-                handle_file(path, file_mask_regex, groups);
+                handle_file(path, dir_id, file_mask_regex, path_store, on_file);
                 continue;
             }
 
-            if (is_symlink(path))
-            {
-                // TODO: handle symlinks
-            }
+            // Links are resolved by the checks above, so broken links and links to special files are skipped.
         }
     }
-    return groups;
 }
 
-void DirectoryScanner::handle_file(const boost::filesystem::path& path, const std::regex& file_mask_regex, GroupedBySizeMap& groups)
+void DirectoryScanner::handle_file(const boost::filesystem::path& path, PathStore::DirectoryId dir_id,
+    const std::regex& file_mask_regex, PathStore* path_store, const FileHandler& on_file)
 {
+    if (m_progress_reporter && path_store)
+    {
+        m_progress_reporter->add_files_scanned(1);
+    }
+
     const auto file_name = path.filename().string();
     std::smatch what;
-    if (!std::regex_match(file_name, what, file_mask_regex))
+    const bool is_matched = std::regex_match(file_name, what, file_mask_regex);
+    const bool is_archive = m_options.scan_archives && is_tar_archive(file_name);
+    if (!is_matched && !is_archive)
+    {
+        return;
+    }
+
+    if (!try_visit(path))
+    {
+        return;
+    }
+
+    if (is_archive)
+    {
+        handle_archive(path.string(), file_name, dir_id, file_mask_regex, path_store, on_file);
+    }
+    if (!is_matched)
     {
         return;
     }
@@ -131,14 +356,345 @@ void DirectoryScanner::handle_file(const boost::filesystem::path& path, const st
         return;
     }
 
-    const auto& path_string = path.string();
-    if (groups.contains(size))
+    on_file(size, dir_id, file_name);
+}
+
+void DirectoryScanner::handle_archive(const std::string& archive_path, const std::string& archive_name, PathStore::DirectoryId dir_id,
+    const std::regex& file_mask_regex, PathStore* path_store, const FileHandler& on_file)
+{
+    // The second pass of a memory lean scan takes headers, read by the counting pass.
+    std::vector<TarMember> members;
+    if (const auto headers = m_archive_headers.find(archive_path); headers != m_archive_headers.end())
     {
-        auto& set = groups[size];
-        set.insert(path_string);
+        members = std::move(headers->second);
+        m_archive_headers.erase(headers);
     }
     else
     {
-        groups[size] = { path_string };
+        // An archive, which can't be read, is still reported as a file, if it matches the mask.
+        try
+        {
+            throttle_metadata();
+            members = read_tar_members(archive_path, m_throttle, m_cancellation_token);
+        }
+        catch (const OperationCanceledError&)
+        {
+            throw;
+        }
+        catch (const std::runtime_error&)
+        {
+            return;
+        }
+
+        if (!path_store)
+        {
+            m_archive_headers.emplace(archive_path, members);
+        }
     }
+
+    // Member directories are stored once per archive, keyed by their path inside it. The root key is empty.
+    const auto archive_id = path_store ? m_archive_members.add_archive(archive_path) : ArchiveMembers::ArchiveId {};
+    std::unordered_map<std::string, PathStore::DirectoryId> member_dir_ids;
+    auto get_member_dir_id = [&](const std::string& member_name, size_t name_begin)
+    {
+        auto [root, is_root_added] = member_dir_ids.try_emplace(std::string(), PathStore::no_directory);
+        if (is_root_added)
+        {
+            root->second = path_store->add_directory(dir_id, archive_name + '!');
+        }
+
+        auto parent = root->second;
+        for (size_t begin = 0; begin < name_begin;)
+        {
+            const auto end = member_name.find('/', begin);
+            auto [directory, is_added] = member_dir_ids.try_emplace(member_name.substr(0, end), PathStore::no_directory);
+            if (is_added)
+            {
+                directory->second = path_store->add_directory(parent, member_name.substr(begin, end - begin));
+            }
+            parent = directory->second;
+            begin = end + 1;
+        }
+        return parent;
+    };
+
+    for (const auto& member : members)
+    {
+        m_cancellation_token.throw_if_cancellation_requested();
+
+        const auto separator = member.name.rfind('/');
+        const auto name_begin = separator == std::string::npos ? 0 : separator + 1;
+        const auto member_file_name = member.name.substr(name_begin);
+        std::smatch what;
+        if (member.size < m_min_file_size_bytes || !std::regex_match(member_file_name, what, file_mask_regex))
+        {
+            continue;
+        }
+
+        if (!path_store)
+        {
+            on_file(member.size, PathStore::no_directory, member_file_name);
+            continue;
+        }
+
+        // The handler stores a reported file with the next file id, if it keeps the file.
+        const auto files_count = path_store->files_count();
+        on_file(member.size, get_member_dir_id(member.name, name_begin), member_file_name);
+        if (path_store->files_count() > files_count)
+        {
+            m_archive_members.add_member(static_cast<PathStore::FileId>(files_count), archive_id, member);
+        }
+    }
+}
+
+bool DirectoryScanner::try_visit(const boost::filesystem::path& path)
+{
+    if (!m_options.follow_symlinks)
+    {
+        return true;
+    }
+
+    // A target, which can't be identified, is visited as is.
+    struct stat target_stat {};
+    if (::stat(path.c_str(), &target_stat) != 0)
+    {
+        return true;
+    }
+
+    return try_visit(FileIdentity { static_cast<std::uint64_t>(target_stat.st_dev), static_cast<std::uint64_t>(target_stat.st_ino) });
+}
+
+bool DirectoryScanner::try_visit(const FileIdentity& identity)
+{
+    return !m_options.follow_symlinks || m_visited.insert(identity).second;
+}
+
+bool DirectoryScanner::is_excluded(const std::string& dir_path) const
+{
+    return std::find(m_exclude_dirs.begin(), m_exclude_dirs.end(), dir_path) != m_exclude_dirs.end();
+}
+
+// A root, which is repeated or is reached by the walk of another root, is dropped, so its files aren't found twice.
+// Roots are compared by canonical paths. A root inside an excluded directory of another root is kept.
+std::vector<std::string> DirectoryScanner::get_root_paths(bool is_recursive) const
+{
+    std::vector<boost::filesystem::path> canonical_paths;
+    canonical_paths.reserve(m_dir_paths.size());
+    for (const auto& dir_path : m_dir_paths)
+    {
+        // A root, which can't be resolved, is kept, so the walk reports it.
+        boost::system::error_code error;
+        auto canonical_path = boost::filesystem::canonical(dir_path, error);
+        canonical_paths.push_back(error ? boost::filesystem::path() : std::move(canonical_path));
+    }
+
+    auto is_covered_by = [&](size_t root, size_t other)
+    {
+        std::vector<boost::filesystem::path> components;
+        if (!try_get_relative_components(canonical_paths[root], canonical_paths[other], components))
+        {
+            return false;
+        }
+        if (components.empty())
+        {
+            return other < root;
+        }
+        if (!is_recursive)
+        {
+            return false;
+        }
+
+        // Directories are excluded by paths, which the walk of the other root builds.
+        boost::filesystem::path walk_path(m_dir_paths[other]);
+        for (const auto& component : components)
+        {
+            walk_path /= component;
+            if (is_excluded(walk_path.string()))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<std::string> root_paths;
+    for (size_t root = 0; root < m_dir_paths.size(); ++root)
+    {
+        bool is_covered = false;
+        for (size_t other = 0; other < m_dir_paths.size() && !is_covered && !canonical_paths[root].empty(); ++other)
+        {
+            is_covered = other != root && !canonical_paths[other].empty() && is_covered_by(root, other);
+        }
+        if (!is_covered)
+        {
+            root_paths.push_back(m_dir_paths[root]);
+        }
+    }
+    return root_paths;
+}
+
+#ifdef __linux__
+void DirectoryScanner::native_scan(PathStore* path_store, const std::regex& file_mask_regex, bool is_recursive, const FileHandler& on_file)
+{
+    std::vector<char> buffer(directory_entries_buffer_size);
+    for (const auto& dir_path : get_root_paths(is_recursive))
+    {
+        TraceSpan span("scan", "directory");
+        DirectoryDescriptor dir_fd(::open(dir_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+        struct stat dir_stat {};
+        if (dir_fd.get() < 0 || ::fstat(dir_fd.get(), &dir_stat) != 0)
+        {
+            throw std::runtime_error("'" + dir_path + "'" + " is not a directory.");
+        }
+
+        if (!try_visit(FileIdentity { static_cast<std::uint64_t>(dir_stat.st_dev), static_cast<std::uint64_t>(dir_stat.st_ino) }))
+        {
+            continue;
+        }
+
+        auto dir_id = path_store ? path_store->add_directory(PathStore::no_directory, dir_path) : PathStore::no_directory;
+        auto path = dir_path;
+        native_scan_directory(dir_fd.get(), path, dir_id, path_store, file_mask_regex, is_recursive, on_file, buffer);
+    }
+}
+
+void DirectoryScanner::native_scan_directory(int dir_fd, std::string& dir_path, PathStore::DirectoryId dir_id, PathStore* path_store,
+    const std::regex& file_mask_regex, bool is_recursive, const FileHandler& on_file, std::vector<char>& buffer)
+{
+    // Subdirectories are walked after all entries are read, so the entries buffer is shared by all levels.
+    std::vector<std::string> subdirectories;
+    for (;;)
+    {
+        throttle_metadata();
+        const auto count = ::syscall(SYS_getdents64, dir_fd, buffer.data(), buffer.size());
+        if (count < 0)
+        {
+            if (errno == EINTR) { continue; }
+            throw filesystem_error("Can't read directory", dir_path, boost::system::error_code(errno, boost::system::system_category()));
+        }
+        if (count == 0)
+        {
+            break;
+        }
+
+        for (long position = 0; position < count;)
+        {
+            // getdents64 records have the layout of glibc dirent64, their names are null-terminated.
+            const auto* entry = reinterpret_cast<const struct dirent64*>(buffer.data() + position);
+            position += entry->d_reclen;
+
+            const std::string name = entry->d_name;
+            if (name == "." || name == "..")
+            {
+                continue;
+            }
+
+            m_cancellation_token.throw_if_cancellation_requested();
+
+            // Only links and entries of file systems without d_type support need a stat to be classified.
+            auto type = entry->d_type;
+            const bool is_link = type == DT_LNK;
+            if (type == DT_LNK || type == DT_UNKNOWN)
+            {
+                struct stat target_stat {};
+                throttle_metadata();
+                if (::fstatat(dir_fd, name.c_str(), &target_stat, 0) != 0)
+                {
+                    continue;
+                }
+                type = S_ISDIR(target_stat.st_mode) ? DT_DIR : S_ISREG(target_stat.st_mode) ? DT_REG : DT_UNKNOWN;
+            }
+
+            if (type == DT_DIR)
+            {
+                if (is_recursive && (!is_link || m_options.follow_symlinks))
+                {
+                    subdirectories.push_back(name);
+                }
+                continue;
+            }
+
+            if (type == DT_REG)
+            {
+                handle_native_file(dir_fd, dir_path, name, dir_id, file_mask_regex, path_store, on_file);
+            }
+        }
+    }
+
+    for (const auto& name : subdirectories)
+    {
+        const auto dir_path_size = dir_path.size();
+        dir_path = join_path(dir_path, name);
+
+        if (!is_excluded(dir_path))
+        {
+            const int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | (m_options.follow_symlinks ? 0 : O_NOFOLLOW);
+            throttle_metadata();
+            DirectoryDescriptor subdirectory_fd(::openat(dir_fd, name.c_str(), flags));
+            if (subdirectory_fd.get() < 0)
+            {
+                throw filesystem_error("Can't open directory", dir_path, boost::system::error_code(errno, boost::system::system_category()));
+            }
+
+            struct stat subdirectory_stat {};
+            const bool is_visited = m_options.follow_symlinks && ::fstat(subdirectory_fd.get(), &subdirectory_stat) == 0
+                && !try_visit(FileIdentity { static_cast<std::uint64_t>(subdirectory_stat.st_dev), static_cast<std::uint64_t>(subdirectory_stat.st_ino) });
+            if (!is_visited)
+            {
+                auto subdirectory_id = path_store ? path_store->add_directory(dir_id, name) : PathStore::no_directory;
+                native_scan_directory(subdirectory_fd.get(), dir_path, subdirectory_id, path_store,
+                    file_mask_regex, is_recursive, on_file, buffer);
+            }
+        }
+
+        dir_path.resize(dir_path_size);
+    }
+}
+
+void DirectoryScanner::handle_native_file(int dir_fd, const std::string& dir_path, const std::string& file_name,
+    PathStore::DirectoryId dir_id, const std::regex& file_mask_regex, PathStore* path_store, const FileHandler& on_file)
+{
+    if (m_progress_reporter && path_store)
+    {
+        m_progress_reporter->add_files_scanned(1);
+    }
+
+    std::smatch what;
+    const bool is_matched = std::regex_match(file_name, what, file_mask_regex);
+    const bool is_archive = m_options.scan_archives && is_tar_archive(file_name);
+    if (!is_matched && !is_archive)
+    {
+        return;
+    }
+
+    // The only metadata call per file. A file, removed since it was listed, is skipped.
+    struct statx file_statx {};
+    const unsigned mask = STATX_SIZE | (m_options.follow_symlinks ? STATX_INO : 0);
+    throttle_metadata();
+    if (::statx(dir_fd, file_name.c_str(), 0, mask, &file_statx) != 0)
+    {
+        return;
+    }
+
+    if (!try_visit(FileIdentity { static_cast<std::uint64_t>(makedev(file_statx.stx_dev_major, file_statx.stx_dev_minor)), file_statx.stx_ino }))
+    {
+        return;
+    }
+
+    if (is_archive)
+    {
+        handle_archive(join_path(dir_path, file_name), file_name, dir_id, file_mask_regex, path_store, on_file);
+    }
+    if (!is_matched)
+    {
+        return;
+    }
+
+    if (file_statx.stx_size < m_min_file_size_bytes)
+    {
+        return;
+    }
+
+    on_file(file_statx.stx_size, dir_id, file_name);
 }
+#endif
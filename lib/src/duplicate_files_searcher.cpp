@@ -1,11 +1,41 @@
 #include "../include/duplicate_files_searcher.h"
 
+#include "../include/comparison_engine.h"
+#include "../include/tracing.h"
+
+#include <algorithm>
+#include <iterator>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
 
 using namespace bayan;
 
+
+/**
+ * @brief State of a single search run.
+ */
+struct DuplicateFilesSearcher::SearchContext
+{
+    BudgetTracker budget;
+    CancellationToken cancellation_token;
+    ProgressReporter progress;
+    ArchiveMembers archive_members;
+};
+
+/**
+ * @brief Resolved and unresolved groups of a single search run.
+ */
+struct DuplicateFilesSearcher::SearchResult
+{
+    std::vector<PathStore::FileId> members;
+    std::vector<size_t> offsets { 0 };
+    std::vector<DuplicateGroups::GroupInfo> infos;
+    std::vector<PathStore::FileId> unresolved_members;
+    std::vector<size_t> unresolved_offsets { 0 };
+};
+
 /**
  * @brief Creates instance of @link DuplicateFilesSearcher::DuplicateFilesSearcher @endlink.
  *
@@ -17,19 +47,14 @@ using namespace bayan;
  */
 DuplicateFilesSearcher::DuplicateFilesSearcher(size_t block_size, HashAlgorithm hash_algorithm, size_t min_file_size_bytes)
     : m_block_size{block_size},
-    m_min_file_size_bytes{min_file_size_bytes}
-{
-    switch (hash_algorithm)
-    {
-        case HashAlgorithm::MD5:
-            m_hash = std::make_shared<MD5>();
-            break;
-        
-        default:
-            m_hash = std::make_shared<CRC32>();
-            break;
-    }
-}
+    m_min_file_size_bytes{min_file_size_bytes},
+    m_hash_algorithm{hash_algorithm},
+    m_scheduling_policy{SchedulingPolicy::LargestPayoffFirst},
+    m_budget{},
+    m_block_reader{BlockReaderType::Posix},
+    m_scan_options{},
+    m_throttle{}
+{}
 
 /**
  * @brief run search for duplicate files.
@@ -47,85 +72,199 @@ DuplicateFilesSearcher::DuplicateFilesSearcher(size_t block_size, HashAlgorithm
 DuplicateFilesSearcher::Duplicates DuplicateFilesSearcher::run(const std::vector<std::string>& dir_paths,
     const std::vector<std::string>& exclude_dirs, const std::string& file_mask, bool is_recursive)
 {
-    DirectoryScanner scanner(dir_paths, exclude_dirs, m_min_file_size_bytes);
-    auto grouped_by_size = scanner.scan(file_mask, is_recursive);
-    FileHashToPathBimap file_path_to_hash;
-
-    for (auto& group : grouped_by_size)
-    {
-        if (group.second.size() < 2) { continue; }
+    SearchContext context { BudgetTracker(m_budget), CancellationToken(), ProgressReporter(), ArchiveMembers() };
+    return search(dir_paths, exclude_dirs, file_mask, is_recursive, context);
+}
 
-        std::unordered_map<std::string, ComparableFileContent> file_content_cache(group.second.size());
-        auto end = group.second.end();
+/**
+ * @brief run_async starts search for duplicate files on the executor.
+ * The searcher settings are copied, so several searches can run concurrently.
+ *
+ * @param options executor, cancellation token and progress callback.
+ *
+ * @param dir_paths collection of paths to target directories.
+ *
+ * @param exclude_dir collection of paths to directories that msut be excluded from the search.
+ *
+ * @param file_mask defines which file names would be included into search.
+ *
+ * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
+ *
+ * @return future of grouped duplicates. It holds @link OperationCanceledError @endlink, if the search was canceled.
+ */
+std::future<DuplicateFilesSearcher::Duplicates> DuplicateFilesSearcher::run_async(const AsyncSearchOptions& options,
+    const std::vector<std::string>& dir_paths, const std::vector<std::string>& exclude_dirs, const std::string& file_mask, bool is_recursive) const
+{
+    auto promise = std::make_shared<std::promise<Duplicates>>();
+    auto future = promise->get_future();
 
-        for (auto iter_left = group.second.begin(); iter_left != end; ++iter_left)
+    std::function<void()> task = [searcher = *this, options, dir_paths, exclude_dirs, file_mask, is_recursive, promise]()
+    {
+        try
         {
-            const std::string& file_path_left = *iter_left;
-            auto& file_content_left = get_file_content(file_content_cache, file_path_left);
-
-            std::unordered_set<std::string>::iterator it_r(iter_left);
-            for (auto iter_right = ++it_r; iter_right != end; ++iter_right)
+            SearchContext context
             {
-                const std::string& file_path_right = *iter_right;
-                auto& file_content_right = get_file_content(file_content_cache, file_path_right);
-
-                if (file_content_left == file_content_right)
-                {
-                    replace_file_to_hash(file_path_to_hash, file_path_left, file_content_left);
-                    replace_file_to_hash(file_path_to_hash, file_path_right, file_content_right);
-                }
-            }
+                BudgetTracker(searcher.m_budget),
+                options.cancellation_token,
+                ProgressReporter(options.on_progress, options.progress_interval),
+                ArchiveMembers()
+            };
+            promise->set_value(searcher.search(dir_paths, exclude_dirs, file_mask, is_recursive, context));
         }
+        catch (...)
+        {
+            promise->set_exception(std::current_exception());
+        }
+    };
+
+    if (options.executor)
+    {
+        options.executor(std::move(task));
+    }
+    else
+    {
+        std::thread(std::move(task)).detach();
     }
 
-    return build_duplicates(grouped_by_size, file_path_to_hash);
+    return future;
 }
 
-ComparableFileContent& DuplicateFilesSearcher::get_file_content(
-        std::unordered_map<std::string, ComparableFileContent>& file_content_cache, const std::string& file_path) const
+/**
+ * @brief Sets the order, in which groups of same sized files are compared.
+ *
+ * @param policy scheduling policy.
+ */
+void DuplicateFilesSearcher::set_scheduling_policy(SchedulingPolicy policy) noexcept
 {
-    if (!file_content_cache.contains(file_path))
-    {
-        file_content_cache.emplace(file_path, ComparableFileContent(file_path, m_block_size, m_hash));
-    }
-    return file_content_cache.at(file_path);
+    m_scheduling_policy = policy;
 }
 
-DuplicateFilesSearcher::Duplicates DuplicateFilesSearcher::build_duplicates(
-        const bayan::DirectoryScanner::GroupedBySizeMap& grouped_by_size, const FileHashToPathBimap& file_path_to_hash)
+/**
+ * @brief Sets limits of each search run.
+ *
+ * @param budget search limits.
+ */
+void DuplicateFilesSearcher::set_budget(const SearchBudget& budget) noexcept
 {
-    DuplicateFilesSearcher::Duplicates grouped_duplicates;
-    grouped_duplicates.reserve(grouped_by_size.size());
+    m_budget = budget;
+}
 
-    std::unordered_map<std::string, bool> processed_hashes;
-    for (const auto& [file_path, hash] : file_path_to_hash)
-    {
-        if (processed_hashes.contains(hash))
-        {
-            continue;
-        }
+/**
+ * @brief Sets the way file blocks are read.
+ *
+ * @param block_reader block reader type.
+ */
+void DuplicateFilesSearcher::set_block_reader(BlockReaderType block_reader) noexcept
+{
+    m_block_reader = block_reader;
+}
 
-        auto duplicate_group = file_path_to_hash.by<FileHash>().equal_range(hash);
-        processed_hashes.emplace(hash, true);
+/**
+ * @brief Sets options of directory scanning.
+ *
+ * @param scan_options scan options.
+ */
+void DuplicateFilesSearcher::set_scan_options(const ScanOptions& scan_options) noexcept
+{
+    m_scan_options = scan_options;
+}
 
-        std::unordered_set<std::string> s;
-        for(auto iter = duplicate_group.first; iter != duplicate_group.second; ++iter)
-        {
-            s.insert(iter->second);
-        }
+/**
+ * @brief Sets throttle of file reads and metadata operations. It is shared by all runs,
+ * so its limits may be changed while they run.
+ *
+ * @param throttle I/O throttle or nullptr.
+ */
+void DuplicateFilesSearcher::set_throttle(std::shared_ptr<IoThrottle> throttle) noexcept
+{
+    m_throttle = std::move(throttle);
+}
+
+DuplicateFilesSearcher::Duplicates DuplicateFilesSearcher::search(const std::vector<std::string>& dir_paths,
+    const std::vector<std::string>& exclude_dirs, const std::string& file_mask, bool is_recursive, SearchContext& context) const
+{
+    TraceSpan span("search", "search");
+    PathStore path_store;
+    DirectoryScanner scanner(dir_paths, exclude_dirs, m_min_file_size_bytes);
+    scanner.set_cancellation_token(context.cancellation_token);
+    scanner.set_progress_reporter(&context.progress);
+    scanner.set_scan_options(m_scan_options);
+    scanner.set_throttle(m_throttle.get());
+    auto grouped_by_size = scanner.scan(path_store, file_mask, is_recursive);
+    context.archive_members = scanner.take_archive_members();
+
+    auto tasks = GroupScheduler(m_scheduling_policy).schedule(grouped_by_size);
+    context.progress.set_groups_total(tasks.size());
 
-        grouped_duplicates.push_back(std::move(s));
+    // The comparison engine is specialized once per run, not per block.
+    SearchResult result;
+    switch (m_hash_algorithm)
+    {
+        case HashAlgorithm::MD5:
+            resolve_groups<Md5Hasher>(tasks, path_store, context, result);
+            break;
+
+        default:
+            resolve_groups<Crc32Hasher>(tasks, path_store, context, result);
+            break;
     }
 
-    return grouped_duplicates;
+    context.progress.flush();
+    Duplicates duplicates(std::move(path_store), std::move(result.members), std::move(result.offsets), std::move(result.infos),
+        std::move(result.unresolved_members), std::move(result.unresolved_offsets));
+    duplicates.set_archive_members(context.archive_members.get_file_ids());
+    return duplicates;
 }
 
-void DuplicateFilesSearcher::replace_file_to_hash(
-        FileHashToPathBimap& file_path_to_hash, const std::string& file_path, const ComparableFileContent& file_content)
+template <typename THasher>
+void DuplicateFilesSearcher::resolve_groups(const std::vector<GroupScheduler::Task>& tasks, const PathStore& path_store,
+    SearchContext& context, SearchResult& result) const
 {
-    if (file_path_to_hash.left.count(file_path) != 0)
+    switch (m_block_reader)
     {
-        file_path_to_hash.left.erase(file_path);
+        case BlockReaderType::Stream:
+            resolve_groups<THasher, StreamBlockReader>(tasks, path_store, context, result);
+            break;
+
+        default:
+            resolve_groups<THasher, PosixBlockReader>(tasks, path_store, context, result);
+            break;
+    }
+}
+
+template <typename THasher, typename TReader>
+void DuplicateFilesSearcher::resolve_groups(const std::vector<GroupScheduler::Task>& tasks, const PathStore& path_store,
+    SearchContext& context, SearchResult& result) const
+{
+    ComparisonEngine<THasher, TReader> engine(m_block_size);
+    engine.set_throttle(m_throttle.get());
+
+    // Candidate members of all groups are hashed first, so data of each archive is read in one sequential pass.
+    if (!context.archive_members.empty())
+    {
+        std::vector<PathStore::FileId> member_ids;
+        for (const auto& task : tasks)
+        {
+            std::copy_if(task.file_ids.begin(), task.file_ids.end(), std::back_inserter(member_ids),
+                [&context](PathStore::FileId file_id) { return context.archive_members.contains(file_id); });
+        }
+        context.archive_members.hash<THasher>(member_ids, m_block_size, context.budget, context.cancellation_token, context.progress,
+            m_throttle.get());
+        engine.set_archive_members(&context.archive_members);
+    }
+
+    for (const auto& task : tasks)
+    {
+        TraceSpan span("search", "group", task.file_size);
+        if (context.budget.is_exhausted()
+            || !engine.resolve_group(task, path_store, context.budget, context.cancellation_token, context.progress))
+        {
+            result.unresolved_members.insert(result.unresolved_members.end(), task.file_ids.begin(), task.file_ids.end());
+            result.unresolved_offsets.push_back(result.unresolved_members.size());
+            continue;
+        }
+
+        engine.append_groups(result.members, result.offsets, result.infos);
+        context.progress.add_groups_resolved(1);
     }
-    file_path_to_hash.insert({ file_path, file_content.get_hash_from_already_read_content() });
 }
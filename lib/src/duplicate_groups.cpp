@@ -0,0 +1,163 @@
+#include "../include/duplicate_groups.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace bayan;
+
+/**
+ * @brief Creates instance of @link DuplicateGroups::DuplicateGroups @endlink.
+ *
+ * @param paths storage of paths, referenced by file ids.
+ *
+ * @param members file ids of all groups, stored one group after another.
+ *
+ * @param offsets offsets of groups in the members array, starting with 0 and ending with members count.
+ *
+ * @param infos properties of each group.
+ *
+ * @param unresolved_members file ids of all unresolved groups of candidates.
+ *
+ * @param unresolved_offsets offsets of unresolved groups in the unresolved members array.
+ */
+DuplicateGroups::DuplicateGroups(PathStore&& paths, std::vector<PathStore::FileId>&& members, std::vector<size_t>&& offsets,
+    std::vector<GroupInfo>&& infos, std::vector<PathStore::FileId>&& unresolved_members, std::vector<size_t>&& unresolved_offsets)
+    : m_paths{std::move(paths)},
+    m_members{std::move(members)},
+    m_offsets{std::move(offsets)},
+    m_infos{std::move(infos)},
+    m_unresolved_members{std::move(unresolved_members)},
+    m_unresolved_offsets{std::move(unresolved_offsets)}
+{
+    if (m_offsets.empty() || m_offsets.front() != 0 || m_offsets.back() != m_members.size())
+    {
+        throw std::invalid_argument("Group offsets do not match members.");
+    }
+
+    if (m_infos.size() != m_offsets.size() - 1)
+    {
+        throw std::invalid_argument("Group infos do not match groups.");
+    }
+
+    if (m_unresolved_offsets.empty() || m_unresolved_offsets.front() != 0 || m_unresolved_offsets.back() != m_unresolved_members.size())
+    {
+        throw std::invalid_argument("Unresolved group offsets do not match members.");
+    }
+}
+
+/**
+ * @brief Gets count of groups.
+ */
+size_t DuplicateGroups::size() const noexcept
+{
+    return m_offsets.size() - 1;
+}
+
+/**
+ * @brief Checks whether there are no groups.
+ */
+bool DuplicateGroups::empty() const noexcept
+{
+    return size() == 0;
+}
+
+/**
+ * @brief Gets group of identical files by index.
+ *
+ * @param index group index.
+ *
+ * @return file ids of the group.
+ */
+DuplicateGroups::Group DuplicateGroups::operator[](size_t index) const
+{
+    return get_group(m_members, m_offsets, index);
+}
+
+/**
+ * @brief Gets common properties of files in the group.
+ *
+ * @param index group index.
+ */
+const DuplicateGroups::GroupInfo& DuplicateGroups::get_info(size_t index) const
+{
+    return m_infos.at(index);
+}
+
+/**
+ * @brief Gets count of unresolved groups of candidates.
+ */
+size_t DuplicateGroups::unresolved_size() const noexcept
+{
+    return m_unresolved_offsets.size() - 1;
+}
+
+/**
+ * @brief Gets unresolved group of candidates by index. Its files have the same size,
+ * but were not compared completely.
+ *
+ * @param index unresolved group index.
+ *
+ * @return file ids of the unresolved group.
+ */
+DuplicateGroups::Group DuplicateGroups::get_unresolved(size_t index) const
+{
+    return get_group(m_unresolved_members, m_unresolved_offsets, index);
+}
+
+/**
+ * @brief Checks whether all candidates were compared.
+ */
+bool DuplicateGroups::is_complete() const noexcept
+{
+    return unresolved_size() == 0;
+}
+
+/**
+ * @brief Rebuilds full path of the file.
+ *
+ * @param file_id file identifier.
+ *
+ * @return full file path.
+ */
+std::string DuplicateGroups::get_path(PathStore::FileId file_id) const
+{
+    return m_paths.get_path(file_id);
+}
+
+/**
+ * @brief Gets storage of paths.
+ */
+const PathStore& DuplicateGroups::get_paths() const noexcept
+{
+    return m_paths;
+}
+
+/**
+ * @brief Marks files, which are members of archives and don't exist on disk by their paths.
+ *
+ * @param file_ids file ids of archive members.
+ */
+void DuplicateGroups::set_archive_members(std::vector<PathStore::FileId>&& file_ids)
+{
+    m_archive_members = std::move(file_ids);
+    std::sort(m_archive_members.begin(), m_archive_members.end());
+}
+
+/**
+ * @brief Checks whether the file is a member of an archive.
+ *
+ * @param file_id file identifier.
+ */
+bool DuplicateGroups::is_archive_member(PathStore::FileId file_id) const
+{
+    return std::binary_search(m_archive_members.begin(), m_archive_members.end(), file_id);
+}
+
+DuplicateGroups::Group DuplicateGroups::get_group(const std::vector<PathStore::FileId>& members, const std::vector<size_t>& offsets, size_t index)
+{
+    if (index + 1 >= offsets.size())
+    {
+        throw std::out_of_range("Group index is out of range.");
+    }
+    return Group(members).subspan(offsets[index], offsets[index + 1] - offsets[index]);
+}
@@ -0,0 +1,410 @@
+#include "../include/duplicate_index.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace bayan;
+using namespace bayan::hashing;
+
+namespace
+{
+    constexpr char index_magic[8] = { 'B', 'A', 'Y', 'A', 'N', 'I', 'D', 'X' };
+    constexpr size_t section_alignment = 8;
+
+    bool group_less(const DuplicateIndex::GroupRecord& left, std::uintmax_t file_size, const Digest& digest) noexcept
+    {
+        return left.file_size != file_size ? left.file_size < file_size : left.digest.bytes < digest.bytes;
+    }
+}
+
+/**
+ * @brief Fixed-size header of the index file. Offsets are counted from the start of the file.
+ */
+struct DuplicateIndex::Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t hash_algorithm;
+    std::uint64_t block_size;
+    std::uint64_t groups_offset;
+    std::uint64_t groups_count;
+    std::uint64_t members_offset;
+    std::uint64_t members_count;
+    std::uint64_t file_groups_offset;
+    std::uint64_t path_hashes_offset;
+    std::uint64_t files_offset;
+    std::uint64_t files_count;
+    std::uint64_t directories_offset;
+    std::uint64_t directories_count;
+    std::uint64_t names_offset;
+    std::uint64_t names_size;
+};
+
+/**
+ * @brief Writes search results to the index file. The file is replaced atomically.
+ *
+ * @param file_path path to the index file.
+ *
+ * @param duplicates search results.
+ *
+ * @param hash_algorithm hash algorithm of group digests.
+ *
+ * @param block_size block size of group digests.
+ */
+void DuplicateIndex::write(const std::string& file_path, const DuplicateGroups& duplicates,
+    HashAlgorithm hash_algorithm, size_t block_size)
+{
+    const auto paths = duplicates.get_paths().get_view();
+
+    std::vector<size_t> order(duplicates.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&duplicates](size_t left, size_t right)
+    {
+        const auto& left_info = duplicates.get_info(left);
+        const auto& right_info = duplicates.get_info(right);
+        return left_info.file_size != right_info.file_size
+            ? left_info.file_size < right_info.file_size
+            : left_info.digest.bytes < right_info.digest.bytes;
+    });
+
+    std::vector<GroupRecord> groups;
+    std::vector<PathStore::FileId> members;
+    std::vector<GroupId> file_groups(paths.files_count(), no_group);
+    groups.reserve(order.size());
+    for (const auto index : order)
+    {
+        const auto& info = duplicates.get_info(index);
+        const auto group = duplicates[index];
+        const auto group_id = static_cast<GroupId>(groups.size());
+        groups.push_back({ info.file_size, info.digest, members.size(), static_cast<std::uint32_t>(group.size()), 0 });
+        for (const auto file_id : group)
+        {
+            members.push_back(file_id);
+            file_groups[file_id] = group_id;
+        }
+    }
+
+    std::vector<PathHashRecord> path_hashes(paths.files_count());
+    for (PathStore::FileId file_id = 0; file_id < path_hashes.size(); ++file_id)
+    {
+        path_hashes[file_id] = { get_path_hash(paths.get_path(file_id)), file_id, 0 };
+    }
+    std::sort(path_hashes.begin(), path_hashes.end(), [](const PathHashRecord& left, const PathHashRecord& right)
+    {
+        return left.path_hash != right.path_hash ? left.path_hash < right.path_hash : left.file_id < right.file_id;
+    });
+
+    const auto temp_path = file_path + ".tmp";
+    std::ofstream output(temp_path, std::ios::binary | std::ios::trunc);
+    if (!output.is_open())
+    {
+        throw std::runtime_error("Can't create index file: '" + temp_path + '\'');
+    }
+
+    Header header {};
+    std::memcpy(header.magic, index_magic, sizeof(index_magic));
+    header.version = version;
+    header.hash_algorithm = static_cast<std::uint32_t>(hash_algorithm);
+    header.block_size = block_size;
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::uint64_t position = sizeof(header);
+    auto write_section = [&output, &position](const void* data, size_t size)
+    {
+        const auto offset = position;
+        output.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        position += size;
+
+        static constexpr char padding[section_alignment] = {};
+        const auto padding_size = (section_alignment - position % section_alignment) % section_alignment;
+        output.write(padding, static_cast<std::streamsize>(padding_size));
+        position += padding_size;
+        return offset;
+    };
+
+    header.groups_offset = write_section(groups.data(), groups.size() * sizeof(GroupRecord));
+    header.groups_count = groups.size();
+    header.members_offset = write_section(members.data(), members.size() * sizeof(PathStore::FileId));
+    header.members_count = members.size();
+    header.file_groups_offset = write_section(file_groups.data(), file_groups.size() * sizeof(GroupId));
+    header.path_hashes_offset = write_section(path_hashes.data(), path_hashes.size() * sizeof(PathHashRecord));
+    header.files_offset = write_section(paths.get_files().data(), paths.get_files().size_bytes());
+    header.files_count = paths.files_count();
+    header.directories_offset = write_section(paths.get_directories().data(), paths.get_directories().size_bytes());
+    header.directories_count = paths.directories_count();
+    header.names_offset = write_section(paths.get_names().data(), paths.get_names().size());
+    header.names_size = paths.get_names().size();
+
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.close();
+    if (!output)
+    {
+        throw std::runtime_error("Can't write index file: '" + temp_path + '\'');
+    }
+
+    boost::filesystem::rename(temp_path, file_path);
+}
+
+/**
+ * @brief Maps the index file into memory.
+ *
+ * @param file_path path to the index file.
+ */
+DuplicateIndex::DuplicateIndex(const std::string& file_path)
+    : m_data{nullptr},
+    m_size{0},
+    m_header{nullptr}
+{
+    const int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Can't open index file: '" + file_path + '\'');
+    }
+
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(Header))
+    {
+        ::close(fd);
+        throw std::runtime_error("Index file is truncated: '" + file_path + '\'');
+    }
+
+    m_size = file_stat.st_size;
+    m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (m_data == MAP_FAILED)
+    {
+        m_data = nullptr;
+        throw std::runtime_error(std::string("Can't map index file: ") + std::strerror(errno));
+    }
+
+    try
+    {
+        m_header = static_cast<const Header*>(m_data);
+        if (std::memcmp(m_header->magic, index_magic, sizeof(index_magic)) != 0 || m_header->version != version)
+        {
+            throw std::runtime_error("Unsupported index file: '" + file_path + '\'');
+        }
+
+        // Only bounds are checked, so opening doesn't depend on the index size.
+        m_groups = get_section<GroupRecord>(m_header->groups_offset, m_header->groups_count);
+        m_members = get_section<PathStore::FileId>(m_header->members_offset, m_header->members_count);
+        m_file_groups = get_section<GroupId>(m_header->file_groups_offset, m_header->files_count);
+        m_path_hashes = get_section<PathHashRecord>(m_header->path_hashes_offset, m_header->files_count);
+        m_paths = PathStoreView(
+            get_section<PathStore::Entry>(m_header->directories_offset, m_header->directories_count),
+            get_section<PathStore::Entry>(m_header->files_offset, m_header->files_count),
+            get_section<char>(m_header->names_offset, m_header->names_size));
+    }
+    catch (...)
+    {
+        unmap();
+        throw;
+    }
+}
+
+/**
+ * @brief DuplicateIndex move ctor.
+ */
+DuplicateIndex::DuplicateIndex(DuplicateIndex&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)},
+    m_size{std::exchange(other.m_size, 0)},
+    m_header{std::exchange(other.m_header, nullptr)},
+    m_groups{std::exchange(other.m_groups, {})},
+    m_members{std::exchange(other.m_members, {})},
+    m_file_groups{std::exchange(other.m_file_groups, {})},
+    m_path_hashes{std::exchange(other.m_path_hashes, {})},
+    m_paths{std::exchange(other.m_paths, {})}
+{}
+
+DuplicateIndex::~DuplicateIndex()
+{
+    unmap();
+}
+
+/**
+ * @brief Gets hash algorithm of group digests.
+ */
+HashAlgorithm DuplicateIndex::get_hash_algorithm() const noexcept
+{
+    return static_cast<HashAlgorithm>(m_header->hash_algorithm);
+}
+
+/**
+ * @brief Gets block size of group digests.
+ */
+size_t DuplicateIndex::get_block_size() const noexcept
+{
+    return m_header->block_size;
+}
+
+/**
+ * @brief Gets count of groups.
+ */
+size_t DuplicateIndex::groups_count() const noexcept
+{
+    return m_groups.size();
+}
+
+/**
+ * @brief Gets the group by identifier.
+ *
+ * @param group_id group identifier.
+ */
+const DuplicateIndex::GroupRecord& DuplicateIndex::get_group(GroupId group_id) const
+{
+    if (group_id >= m_groups.size())
+    {
+        throw std::out_of_range("Group is out of range.");
+    }
+    return m_groups[group_id];
+}
+
+/**
+ * @brief Gets file ids of the group.
+ *
+ * @param group_id group identifier.
+ */
+std::span<const PathStore::FileId> DuplicateIndex::get_members(GroupId group_id) const
+{
+    const auto& group = get_group(group_id);
+    if (group.members_offset > m_members.size() || group.members_count > m_members.size() - group.members_offset)
+    {
+        throw std::out_of_range("Group members are out of range.");
+    }
+    return m_members.subspan(group.members_offset, group.members_count);
+}
+
+/**
+ * @brief Finds groups of files of the size.
+ *
+ * @param file_size size of file in bytes.
+ *
+ * @return range of group identifiers.
+ */
+std::pair<DuplicateIndex::GroupId, DuplicateIndex::GroupId> DuplicateIndex::find_by_size(std::uintmax_t file_size) const noexcept
+{
+    const auto begin = std::partition_point(m_groups.begin(), m_groups.end(),
+        [file_size](const GroupRecord& group) { return group.file_size < file_size; });
+    const auto end = std::partition_point(begin, m_groups.end(),
+        [file_size](const GroupRecord& group) { return group.file_size == file_size; });
+    return { static_cast<GroupId>(begin - m_groups.begin()), static_cast<GroupId>(end - m_groups.begin()) };
+}
+
+/**
+ * @brief Finds the group of files of the size and content digest.
+ *
+ * @param file_size size of file in bytes.
+ *
+ * @param digest content digest.
+ *
+ * @return group identifier or @link DuplicateIndex::no_group @endlink.
+ */
+DuplicateIndex::GroupId DuplicateIndex::find_by_digest(std::uintmax_t file_size, const Digest& digest) const noexcept
+{
+    auto it = std::partition_point(m_groups.begin(), m_groups.end(),
+        [file_size, &digest](const GroupRecord& group) { return group_less(group, file_size, digest); });
+
+    if (it == m_groups.end() || it->file_size != file_size || it->digest != digest)
+    {
+        return no_group;
+    }
+    return static_cast<GroupId>(it - m_groups.begin());
+}
+
+/**
+ * @brief Finds the group of the file.
+ *
+ * @param file_path full path of the file, as it was found by the search.
+ *
+ * @return group identifier or @link DuplicateIndex::no_group @endlink, if the file is unknown or has no duplicates.
+ */
+DuplicateIndex::GroupId DuplicateIndex::find_by_path(const std::string& file_path) const
+{
+    const auto path_hash = get_path_hash(file_path);
+    auto it = std::lower_bound(m_path_hashes.begin(), m_path_hashes.end(), path_hash,
+        [](const PathHashRecord& record, std::uint64_t hash) { return record.path_hash < hash; });
+
+    // Different paths may have the same hash, so paths of candidates are compared.
+    for (; it != m_path_hashes.end() && it->path_hash == path_hash; ++it)
+    {
+        if (it->file_id < m_file_groups.size() && m_paths.get_path(it->file_id) == file_path)
+        {
+            return m_file_groups[it->file_id];
+        }
+    }
+    return no_group;
+}
+
+/**
+ * @brief Gets interned paths of all searched files.
+ */
+const PathStoreView& DuplicateIndex::get_paths() const noexcept
+{
+    return m_paths;
+}
+
+/**
+ * @brief DuplicateIndex move assignment operator.
+ *
+ * @return reference to assigned instance.
+ */
+DuplicateIndex& DuplicateIndex::operator =(DuplicateIndex&& other) noexcept
+{
+    if (this == &other) { return *this; }
+
+    unmap();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_header = std::exchange(other.m_header, nullptr);
+    m_groups = std::exchange(other.m_groups, {});
+    m_members = std::exchange(other.m_members, {});
+    m_file_groups = std::exchange(other.m_file_groups, {});
+    m_path_hashes = std::exchange(other.m_path_hashes, {});
+    m_paths = std::exchange(other.m_paths, {});
+    return *this;
+}
+
+void DuplicateIndex::unmap() noexcept
+{
+    if (m_data != nullptr)
+    {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+template <typename T>
+std::span<const T> DuplicateIndex::get_section(std::uint64_t offset, std::uint64_t count) const
+{
+    if (offset % alignof(T) != 0 || offset > m_size || count > (m_size - offset) / sizeof(T))
+    {
+        throw std::runtime_error("Index file is corrupted.");
+    }
+    return { reinterpret_cast<const T*>(static_cast<const char*>(m_data) + offset), static_cast<size_t>(count) };
+}
+
+/**
+ * @brief Gets FNV-1a hash of the path.
+ */
+std::uint64_t DuplicateIndex::get_path_hash(std::string_view path) noexcept
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (const auto symbol : path)
+    {
+        hash ^= static_cast<unsigned char>(symbol);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
@@ -0,0 +1,79 @@
+#include "../include/group_scheduler.h"
+
+#include <algorithm>
+
+using namespace bayan;
+
+/**
+ * @brief Creates instance of @link GroupScheduler::GroupScheduler @endlink.
+ *
+ * @param policy scheduling policy.
+ */
+GroupScheduler::GroupScheduler(SchedulingPolicy policy)
+    : m_policy{policy}
+{}
+
+/**
+ * @brief Orders groups, that can contain duplicates, according to the policy.
+ *
+ * @param grouped_by_size file ids, grouped by file size.
+ *
+ * @return ordered groups with at least two files.
+ */
+std::vector<GroupScheduler::Task> GroupScheduler::schedule(const DirectoryScanner::GroupedBySizeMap& grouped_by_size) const
+{
+    std::vector<Task> tasks;
+    tasks.reserve(grouped_by_size.size());
+    for (const auto& [file_size, file_ids] : grouped_by_size)
+    {
+        if (file_ids.size() < 2) { continue; }
+        tasks.push_back({ file_size, file_ids });
+    }
+
+    switch (m_policy)
+    {
+        case SchedulingPolicy::LargestPayoffFirst:
+            std::sort(tasks.begin(), tasks.end(), [](const Task& left, const Task& right)
+            {
+                auto left_payoff = get_expected_payoff(left);
+                auto right_payoff = get_expected_payoff(right);
+                return left_payoff != right_payoff
+                    ? left_payoff > right_payoff
+                    : left.file_size > right.file_size;
+            });
+            break;
+
+        case SchedulingPolicy::LargestFileFirst:
+            std::sort(tasks.begin(), tasks.end(), [](const Task& left, const Task& right)
+            {
+                return left.file_size > right.file_size;
+            });
+            break;
+
+        case SchedulingPolicy::SmallestGroupFirst:
+            std::sort(tasks.begin(), tasks.end(), [](const Task& left, const Task& right)
+            {
+                return left.file_ids.size() != right.file_ids.size()
+                    ? left.file_ids.size() < right.file_ids.size()
+                    : left.file_size > right.file_size;
+            });
+            break;
+
+        default:
+            break;
+    }
+
+    return tasks;
+}
+
+/**
+ * @brief Gets count of bytes, which can be reclaimed, if all files of the group are identical.
+ *
+ * @param task scheduled group.
+ *
+ * @return expected reclaimable bytes.
+ */
+std::uintmax_t GroupScheduler::get_expected_payoff(const Task& task) noexcept
+{
+    return static_cast<std::uintmax_t>(task.file_size) * (task.file_ids.size() - 1);
+}
@@ -1,7 +1,6 @@
 #include "../include/hashing.h"
 
 #include <boost/algorithm/hex.hpp>
-#include <boost/crc.hpp>
 #include <boost/uuid/detail/md5.hpp>
 
 using boost::uuids::detail::md5;
@@ -24,4 +23,4 @@ std::string bayan::hashing::CRC32::get_hash(const std::string& input)
     boost::crc_32_type result;
     result.process_bytes(input.data(), input.length());
     return std::to_string(result.checksum());
-}
\ No newline at end of file
+}
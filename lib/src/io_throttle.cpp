@@ -0,0 +1,172 @@
+#include "../include/io_throttle.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace bayan;
+
+namespace
+{
+    // Waits are sliced, so a changed rate is taken into account quickly.
+    constexpr std::chrono::milliseconds max_wait_slice { 100 };
+}
+
+/**
+ * @brief Creates instance of @link RateLimiter::RateLimiter @endlink.
+ *
+ * @param rate count of tokens per second. Zero means no limit.
+ */
+RateLimiter::RateLimiter(std::uint64_t rate)
+    : m_rate{rate},
+    m_tokens{static_cast<double>(rate)},
+    m_last_refill{std::chrono::steady_clock::now()}
+{}
+
+/**
+ * @brief Sets count of tokens per second. Zero means no limit.
+ *
+ * @param rate count of tokens per second.
+ */
+void RateLimiter::set_rate(std::uint64_t rate)
+{
+    std::lock_guard lock(m_mutex);
+    m_rate.store(rate, std::memory_order_relaxed);
+    m_tokens = std::min(m_tokens, static_cast<double>(rate));
+}
+
+/**
+ * @brief Gets count of tokens per second.
+ */
+std::uint64_t RateLimiter::get_rate() const noexcept
+{
+    return m_rate.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Takes tokens, waiting until they are available.
+ * Waiting stops with @link OperationCanceledError @endlink, when canceled, and ends at the deadline,
+ * so a search with a time budget notices its exhaustion instead of waiting.
+ *
+ * @param tokens count of tokens.
+ *
+ * @param cancellation_token cancellation token.
+ *
+ * @param deadline time, after which tokens are taken without waiting.
+ */
+void RateLimiter::acquire(std::uint64_t tokens, const CancellationToken& cancellation_token,
+    std::chrono::steady_clock::time_point deadline)
+{
+    for (;;)
+    {
+        if (m_rate.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+
+        std::chrono::duration<double> wait_time { 0 };
+        std::chrono::steady_clock::time_point now;
+        {
+            std::lock_guard lock(m_mutex);
+            const auto rate = static_cast<double>(m_rate.load(std::memory_order_relaxed));
+            if (rate == 0)
+            {
+                return;
+            }
+
+            now = std::chrono::steady_clock::now();
+            m_tokens = std::min(m_tokens + std::chrono::duration<double>(now - m_last_refill).count() * rate, rate);
+            m_last_refill = now;
+
+            // Tokens, taken after the deadline, are a debt, which other waiters repay.
+            if (m_tokens >= 0 || now >= deadline)
+            {
+                m_tokens -= static_cast<double>(tokens);
+                return;
+            }
+            wait_time = std::chrono::duration<double>(-m_tokens / rate);
+        }
+
+        cancellation_token.throw_if_cancellation_requested();
+        std::this_thread::sleep_for(std::min<std::chrono::duration<double>>({ wait_time, max_wait_slice, deadline - now }));
+        cancellation_token.throw_if_cancellation_requested();
+    }
+}
+
+/**
+ * @brief Creates instance of @link IoThrottle::IoThrottle @endlink.
+ *
+ * @param limits I/O limits.
+ */
+IoThrottle::IoThrottle(const ThrottleLimits& limits)
+    : m_bytes{limits.bytes_per_second},
+    m_reads{limits.reads_per_second},
+    m_metadata_ops{limits.metadata_ops_per_second}
+{}
+
+/**
+ * @brief Sets I/O limits.
+ *
+ * @param limits I/O limits.
+ */
+void IoThrottle::set_limits(const ThrottleLimits& limits)
+{
+    m_bytes.set_rate(limits.bytes_per_second);
+    m_reads.set_rate(limits.reads_per_second);
+    m_metadata_ops.set_rate(limits.metadata_ops_per_second);
+}
+
+/**
+ * @brief Gets I/O limits.
+ */
+ThrottleLimits IoThrottle::get_limits() const noexcept
+{
+    return { m_bytes.get_rate(), m_reads.get_rate(), m_metadata_ops.get_rate() };
+}
+
+/**
+ * @brief Waits until a read of the size is allowed.
+ *
+ * @param bytes count of bytes to read.
+ *
+ * @param cancellation_token cancellation token.
+ *
+ * @param deadline time, after which the read is allowed without waiting.
+ */
+void IoThrottle::acquire_read(std::uint64_t bytes, const CancellationToken& cancellation_token,
+    std::chrono::steady_clock::time_point deadline)
+{
+    m_reads.acquire(1, cancellation_token, deadline);
+    m_bytes.acquire(bytes, cancellation_token, deadline);
+}
+
+/**
+ * @brief Waits until a metadata operation is allowed.
+ *
+ * @param cancellation_token cancellation token.
+ */
+void IoThrottle::acquire_metadata(const CancellationToken& cancellation_token)
+{
+    m_metadata_ops.acquire(1, cancellation_token);
+}
+
+/**
+ * @brief Sets idle I/O scheduling class for the process, so its I/O is served only when a disk is otherwise idle.
+ *
+ * @return false, if the class is not supported.
+ */
+bool bayan::set_idle_io_priority() noexcept
+{
+#if defined(__linux__) && defined(SYS_ioprio_set)
+    constexpr int ioprio_who_process = 1;
+    constexpr int ioprio_class_idle = 3;
+    constexpr int ioprio_class_shift = 13;
+    return ::syscall(SYS_ioprio_set, ioprio_who_process, 0, ioprio_class_idle << ioprio_class_shift) == 0;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,234 @@
+#include "../include/hashing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+using namespace bayan::hashing;
+
+namespace
+{
+    constexpr size_t md5_chunk_size = 64;
+
+    constexpr std::uint32_t md5_constants[64] =
+    {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+
+    constexpr unsigned md5_shifts[64] =
+    {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+    };
+
+    typedef std::uint32_t u32x4 __attribute__((vector_size(16)));
+    typedef std::uint32_t u32x8 __attribute__((vector_size(32)));
+    typedef std::uint32_t u32x16 __attribute__((vector_size(64)));
+
+    inline std::uint32_t load_word(const unsigned char* bytes) noexcept
+    {
+        return static_cast<std::uint32_t>(bytes[0])
+            | static_cast<std::uint32_t>(bytes[1]) << 8
+            | static_cast<std::uint32_t>(bytes[2]) << 16
+            | static_cast<std::uint32_t>(bytes[3]) << 24;
+    }
+
+    /**
+     * @brief Computes MD5 of Lanes equal-length messages at once, one message per vector lane.
+     *
+     * Messages of all lanes have the same length, so they share the padding layout.
+     * When Lanes is 1, V is a plain 32-bit integer and this is the scalar implementation.
+     */
+    template <typename V, size_t Lanes>
+    inline __attribute__((always_inline)) void md5_lanes(const char* const* messages, size_t size, Digest* digests)
+    {
+        auto set_lane = [](V& vector, size_t lane, std::uint32_t value)
+        {
+            if constexpr (Lanes == 1) { vector = value; }
+            else { vector[lane] = value; }
+        };
+
+        auto get_lane = [](const V& vector, size_t lane) -> std::uint32_t
+        {
+            if constexpr (Lanes == 1) { return vector; }
+            else { return vector[lane]; }
+        };
+
+        // The tail holds the rest of each message, the 0x80 marker, zero padding and the bit length.
+        const size_t full_chunks = size / md5_chunk_size;
+        const size_t rest = size - full_chunks * md5_chunk_size;
+        const size_t tail_size = rest + 1 + 8 <= md5_chunk_size ? md5_chunk_size : 2 * md5_chunk_size;
+
+        alignas(64) unsigned char tails[Lanes][2 * md5_chunk_size];
+        const std::uint64_t bit_length = static_cast<std::uint64_t>(size) * 8;
+        for (size_t lane = 0; lane < Lanes; ++lane)
+        {
+            std::memset(tails[lane], 0, tail_size);
+            std::memcpy(tails[lane], messages[lane] + full_chunks * md5_chunk_size, rest);
+            tails[lane][rest] = 0x80;
+            for (size_t i = 0; i < 8; ++i)
+            {
+                tails[lane][tail_size - 8 + i] = static_cast<unsigned char>(bit_length >> (8 * i));
+            }
+        }
+
+        V a0 = V{} + 0x67452301u;
+        V b0 = V{} + 0xefcdab89u;
+        V c0 = V{} + 0x98badcfeu;
+        V d0 = V{} + 0x10325476u;
+
+        const size_t chunks = full_chunks + tail_size / md5_chunk_size;
+        V words[16];
+        for (size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            for (size_t lane = 0; lane < Lanes; ++lane)
+            {
+                const auto* bytes = chunk < full_chunks
+                    ? reinterpret_cast<const unsigned char*>(messages[lane]) + chunk * md5_chunk_size
+                    : tails[lane] + (chunk - full_chunks) * md5_chunk_size;
+                for (size_t i = 0; i < 16; ++i)
+                {
+                    set_lane(words[i], lane, load_word(bytes + 4 * i));
+                }
+            }
+
+            V a = a0;
+            V b = b0;
+            V c = c0;
+            V d = d0;
+            auto round = [&](size_t i, const V& f, size_t g)
+            {
+                const V sum = f + a + md5_constants[i] + words[g];
+                a = d;
+                d = c;
+                c = b;
+                b = b + ((sum << md5_shifts[i]) | (sum >> (32 - md5_shifts[i])));
+            };
+
+            for (size_t i = 0; i < 16; ++i) { round(i, (b & c) | (~b & d), i); }
+            for (size_t i = 16; i < 32; ++i) { round(i, (d & b) | (~d & c), (5 * i + 1) % 16); }
+            for (size_t i = 32; i < 48; ++i) { round(i, b ^ c ^ d, (3 * i + 5) % 16); }
+            for (size_t i = 48; i < 64; ++i) { round(i, c ^ (b | ~d), (7 * i) % 16); }
+
+            a0 += a;
+            b0 += b;
+            c0 += c;
+            d0 += d;
+        }
+
+        for (size_t lane = 0; lane < Lanes; ++lane)
+        {
+            const std::uint32_t state[4] = { get_lane(a0, lane), get_lane(b0, lane), get_lane(c0, lane), get_lane(d0, lane) };
+            for (size_t i = 0; i < 16; ++i)
+            {
+                digests[lane].bytes[i] = static_cast<std::uint8_t>(state[i / 4] >> (8 * (i % 4)));
+            }
+        }
+    }
+
+    void md5_x1(const char* const* messages, size_t size, Digest* digests)
+    {
+        md5_lanes<std::uint32_t, 1>(messages, size, digests);
+    }
+
+    void md5_x4(const char* const* messages, size_t size, Digest* digests)
+    {
+        md5_lanes<u32x4, 4>(messages, size, digests);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2")))
+    void md5_x8_avx2(const char* const* messages, size_t size, Digest* digests)
+    {
+        md5_lanes<u32x8, 8>(messages, size, digests);
+    }
+
+    __attribute__((target("avx512f")))
+    void md5_x16_avx512(const char* const* messages, size_t size, Digest* digests)
+    {
+        md5_lanes<u32x16, 16>(messages, size, digests);
+    }
+#endif
+
+    using Md5LanesFunction = void (*)(const char* const*, size_t, Digest*);
+
+    struct Md5Dispatch
+    {
+        Md5LanesFunction widest;
+        size_t widest_lanes;
+        Md5LanesFunction middle;
+        size_t middle_lanes;
+    };
+
+    Md5Dispatch select_md5_dispatch() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+        {
+            return { md5_x16_avx512, 16, md5_x8_avx2, 8 };
+        }
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return { md5_x8_avx2, 8, md5_x4, 4 };
+        }
+#endif
+        return { md5_x4, 4, md5_x4, 4 };
+    }
+
+    const Md5Dispatch md5_dispatch = select_md5_dispatch();
+}
+
+/**
+ * @brief Gets binary digest from input bytes.
+ *
+ * @return binary digest.
+ */
+Digest Md5Hasher::operator()(std::string_view input) const noexcept
+{
+    const char* message = input.data();
+    Digest digest;
+    md5_x1(&message, input.size(), &digest);
+    return digest;
+}
+
+/**
+ * @brief Gets binary digests from equal-length blocks. Blocks are hashed in parallel vector lanes
+ * (16 with AVX-512, 8 with AVX2, 4 otherwise), the rest are hashed one by one.
+ *
+ * @param blocks pointers to blocks.
+ *
+ * @param block_size size of every block.
+ *
+ * @param digests destination digests, one per block.
+ */
+void Md5Hasher::operator()(std::span<const char* const> blocks, size_t block_size, std::span<Digest> digests) const noexcept
+{
+    size_t index = 0;
+    const size_t count = std::min(blocks.size(), digests.size());
+    for (; index + md5_dispatch.widest_lanes <= count; index += md5_dispatch.widest_lanes)
+    {
+        md5_dispatch.widest(blocks.data() + index, block_size, digests.data() + index);
+    }
+    for (; index + md5_dispatch.middle_lanes <= count; index += md5_dispatch.middle_lanes)
+    {
+        md5_dispatch.middle(blocks.data() + index, block_size, digests.data() + index);
+    }
+    for (; index + 4 <= count; index += 4)
+    {
+        md5_x4(blocks.data() + index, block_size, digests.data() + index);
+    }
+    for (; index < count; ++index)
+    {
+        md5_x1(blocks.data() + index, block_size, digests.data() + index);
+    }
+}
@@ -0,0 +1,293 @@
+#include "../include/path_store.h"
+
+#include <stdexcept>
+
+using namespace bayan;
+
+/**
+ * @brief Adds a directory to the store.
+ *
+ * @param parent identifier of the parent directory or @link PathStore::no_directory @endlink for a root.
+ *
+ * @param name directory name. For a root directory it is a full path.
+ *
+ * @return identifier of the added directory.
+ */
+PathStore::DirectoryId PathStore::add_directory(DirectoryId parent, std::string_view name)
+{
+    if (m_directories.size() >= no_directory)
+    {
+        throw std::length_error("Too many directories to store.");
+    }
+
+    if (parent != no_directory && parent >= m_directories.size())
+    {
+        throw std::invalid_argument("Parent directory is not stored.");
+    }
+
+    m_directories.push_back(make_entry(parent, name));
+    return static_cast<DirectoryId>(m_directories.size() - 1);
+}
+
+/**
+ * @brief Adds a file to the store.
+ *
+ * @param parent identifier of the parent directory.
+ *
+ * @param name file name.
+ *
+ * @return identifier of the added file.
+ */
+PathStore::FileId PathStore::add_file(DirectoryId parent, std::string_view name)
+{
+    if (m_files.size() >= std::numeric_limits<FileId>::max())
+    {
+        throw std::length_error("Too many files to store.");
+    }
+
+    if (parent != no_directory && parent >= m_directories.size())
+    {
+        throw std::invalid_argument("Parent directory is not stored.");
+    }
+
+    m_files.push_back(make_entry(parent, name));
+    return static_cast<FileId>(m_files.size() - 1);
+}
+
+/**
+ * @brief Rebuilds full path of the file.
+ *
+ * @param file_id file identifier.
+ *
+ * @return full file path.
+ */
+std::string PathStore::get_path(FileId file_id) const
+{
+    return get_view().get_path(file_id);
+}
+
+/**
+ * @brief Rebuilds full path of the directory.
+ *
+ * @param directory_id directory identifier.
+ *
+ * @return full directory path.
+ */
+std::string PathStore::get_directory_path(DirectoryId directory_id) const
+{
+    return get_view().get_directory_path(directory_id);
+}
+
+/**
+ * @brief Gets the file name without parent directories.
+ *
+ * @param file_id file identifier.
+ *
+ * @return file name.
+ */
+std::string_view PathStore::get_name(FileId file_id) const
+{
+    return get_view().get_name(file_id);
+}
+
+/**
+ * @brief Gets the parent directory of the file.
+ *
+ * @param file_id file identifier.
+ *
+ * @return parent directory identifier.
+ */
+PathStore::DirectoryId PathStore::get_parent(FileId file_id) const
+{
+    return get_view().get_parent(file_id);
+}
+
+/**
+ * @brief Gets count of stored files.
+ */
+size_t PathStore::files_count() const noexcept
+{
+    return m_files.size();
+}
+
+/**
+ * @brief Gets count of stored directories.
+ */
+size_t PathStore::directories_count() const noexcept
+{
+    return m_directories.size();
+}
+
+/**
+ * @brief Gets read-only view of the stored entries. It is invalidated, when the store is changed.
+ */
+PathStoreView PathStore::get_view() const noexcept
+{
+    return { m_directories, m_files, m_names };
+}
+
+PathStore::Entry PathStore::make_entry(DirectoryId parent, std::string_view name)
+{
+    if (name.size() > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::length_error("Path component is too long.");
+    }
+
+    Entry entry { m_names.size(), parent, static_cast<std::uint32_t>(name.size()) };
+    m_names.insert(m_names.end(), name.begin(), name.end());
+    return entry;
+}
+
+/**
+ * @brief Creates instance of @link PathStoreView::PathStoreView @endlink.
+ *
+ * @param directories directory entries.
+ *
+ * @param files file entries.
+ *
+ * @param names character arena of entry names.
+ */
+PathStoreView::PathStoreView(std::span<const PathStore::Entry> directories, std::span<const PathStore::Entry> files,
+    std::span<const char> names) noexcept
+    : m_directories{directories},
+    m_files{files},
+    m_names{names}
+{}
+
+/**
+ * @brief Rebuilds full path of the file.
+ *
+ * @param file_id file identifier.
+ *
+ * @return full file path.
+ */
+std::string PathStoreView::get_path(PathStore::FileId file_id) const
+{
+    const auto& entry = get_entry(m_files, file_id);
+
+    std::string path;
+    append_directory_path(entry.parent, path);
+    if (!path.empty() && path.back() != '/')
+    {
+        path.push_back('/');
+    }
+    path.append(get_entry_name(entry));
+    return path;
+}
+
+/**
+ * @brief Rebuilds full path of the directory.
+ *
+ * @param directory_id directory identifier.
+ *
+ * @return full directory path.
+ */
+std::string PathStoreView::get_directory_path(PathStore::DirectoryId directory_id) const
+{
+    std::string path;
+    append_directory_path(directory_id, path);
+    return path;
+}
+
+/**
+ * @brief Gets the file name without parent directories.
+ *
+ * @param file_id file identifier.
+ *
+ * @return file name.
+ */
+std::string_view PathStoreView::get_name(PathStore::FileId file_id) const
+{
+    return get_entry_name(get_entry(m_files, file_id));
+}
+
+/**
+ * @brief Gets the parent directory of the file.
+ *
+ * @param file_id file identifier.
+ *
+ * @return parent directory identifier.
+ */
+PathStore::DirectoryId PathStoreView::get_parent(PathStore::FileId file_id) const
+{
+    return get_entry(m_files, file_id).parent;
+}
+
+/**
+ * @brief Gets count of files.
+ */
+size_t PathStoreView::files_count() const noexcept
+{
+    return m_files.size();
+}
+
+/**
+ * @brief Gets count of directories.
+ */
+size_t PathStoreView::directories_count() const noexcept
+{
+    return m_directories.size();
+}
+
+/**
+ * @brief Gets directory entries.
+ */
+std::span<const PathStore::Entry> PathStoreView::get_directories() const noexcept
+{
+    return m_directories;
+}
+
+/**
+ * @brief Gets file entries.
+ */
+std::span<const PathStore::Entry> PathStoreView::get_files() const noexcept
+{
+    return m_files;
+}
+
+/**
+ * @brief Gets character arena of entry names.
+ */
+std::span<const char> PathStoreView::get_names() const noexcept
+{
+    return m_names;
+}
+
+const PathStore::Entry& PathStoreView::get_entry(std::span<const PathStore::Entry> entries, size_t index) const
+{
+    if (index >= entries.size())
+    {
+        throw std::out_of_range("Path entry is out of range.");
+    }
+    return entries[index];
+}
+
+std::string_view PathStoreView::get_entry_name(const PathStore::Entry& entry) const
+{
+    if (entry.name_offset > m_names.size() || entry.name_length > m_names.size() - entry.name_offset)
+    {
+        throw std::out_of_range("Path entry name is out of range.");
+    }
+    return { m_names.data() + entry.name_offset, entry.name_length };
+}
+
+void PathStoreView::append_directory_path(PathStore::DirectoryId directory_id, std::string& path) const
+{
+    if (directory_id == PathStore::no_directory)
+    {
+        return;
+    }
+
+    // Parents are stored before their children, so a broken entry can't make a cycle.
+    const auto& entry = get_entry(m_directories, directory_id);
+    if (entry.parent != PathStore::no_directory && entry.parent >= directory_id)
+    {
+        throw std::out_of_range("Parent directory is stored after its child.");
+    }
+    append_directory_path(entry.parent, path);
+    if (!path.empty() && path.back() != '/')
+    {
+        path.push_back('/');
+    }
+    path.append(get_entry_name(entry));
+}
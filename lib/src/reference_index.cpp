@@ -0,0 +1,355 @@
+#include "../include/reference_index.h"
+
+#include "../include/comparable_file_content.h"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+using namespace bayan;
+using namespace bayan::hashing;
+
+namespace
+{
+    bool digest_less(const Digest& left, const Digest& right) noexcept
+    {
+        return left.bytes < right.bytes;
+    }
+
+    /**
+     * @brief Gets digest of whole file content by chaining digests of its blocks.
+     */
+    template <typename THasher, typename TReader>
+    Digest compute_file_digest(const std::string& file_path, size_t block_size, size_t file_size, IoThrottle* throttle,
+        const CancellationToken& cancellation_token, ProgressReporter* progress_reporter)
+    {
+        THasher hasher;
+        ComparableFileContent<TReader> file_content(file_path, block_size, file_size);
+        std::string block(block_size, '\0');
+        std::optional<Digest> zero_block_digest;
+
+        // Blocks in holes of sparse files aren't read.
+        Digest digest;
+        for (size_t offset = 0; offset < file_size; offset += block_size)
+        {
+            if (file_content.try_skip_hole_block())
+            {
+                if (!zero_block_digest.has_value())
+                {
+                    zero_block_digest = hasher(std::string(block_size, '\0'));
+                }
+                digest = chain_digest(hasher, digest, *zero_block_digest);
+                continue;
+            }
+
+            cancellation_token.throw_if_cancellation_requested();
+            if (throttle != nullptr)
+            {
+                throttle->acquire_read(block_size, cancellation_token);
+            }
+            const auto count = file_content.read_next_block(block.data());
+            if (progress_reporter != nullptr)
+            {
+                progress_reporter->add_bytes_hashed(count);
+            }
+            digest = chain_digest(hasher, digest, hasher(block));
+        }
+        return digest;
+    }
+}
+
+/**
+ * @brief Creates instance of @link ReferenceMatches::ReferenceMatches @endlink.
+ *
+ * @param query_paths storage of query paths, referenced by query file ids.
+ *
+ * @param query_files ids of matched query files.
+ *
+ * @param references ids of reference files, stored one query file after another.
+ *
+ * @param reference_offsets offsets of references of each query file, starting with 0.
+ */
+ReferenceMatches::ReferenceMatches(PathStore&& query_paths, std::vector<PathStore::FileId>&& query_files,
+    std::vector<PathStore::FileId>&& references, std::vector<size_t>&& reference_offsets)
+    : m_query_paths{std::move(query_paths)},
+    m_query_files{std::move(query_files)},
+    m_references{std::move(references)},
+    m_reference_offsets{std::move(reference_offsets)}
+{
+    if (m_reference_offsets.size() != m_query_files.size() + 1 || m_reference_offsets.back() != m_references.size())
+    {
+        throw std::invalid_argument("Reference offsets don't match query files");
+    }
+}
+
+/**
+ * @brief Gets count of matched query files.
+ */
+size_t ReferenceMatches::size() const noexcept
+{
+    return m_query_files.size();
+}
+
+/**
+ * @brief Checks whether no query file is matched.
+ */
+bool ReferenceMatches::empty() const noexcept
+{
+    return m_query_files.empty();
+}
+
+/**
+ * @brief Gets path of the matched query file.
+ *
+ * @param index index of matched query file.
+ */
+std::string ReferenceMatches::get_query_path(size_t index) const
+{
+    return m_query_paths.get_path(m_query_files.at(index));
+}
+
+/**
+ * @brief Gets reference copies of the matched query file.
+ *
+ * @param index index of matched query file.
+ *
+ * @return ids of reference files. Their paths are kept by the reference index.
+ */
+ReferenceMatches::References ReferenceMatches::get_references(size_t index) const
+{
+    const auto begin = m_reference_offsets.at(index);
+    return References(m_references.data() + begin, m_reference_offsets.at(index + 1) - begin);
+}
+
+/**
+ * @brief Creates instance of @link ReferenceIndex::ReferenceIndex @endlink.
+ *
+ * @param block_size content block size to be read from file.
+ *
+ * @param hash_algorithm hash algorithm type.
+ *
+ * @param min_file_size_bytes minimum file size in bytes.
+ */
+ReferenceIndex::ReferenceIndex(size_t block_size, HashAlgorithm hash_algorithm, size_t min_file_size_bytes)
+    : m_block_size{block_size},
+    m_min_file_size_bytes{min_file_size_bytes},
+    m_hash_algorithm{hash_algorithm},
+    m_block_reader{BlockReaderType::Posix},
+    m_scan_options{},
+    m_cancellation_token{},
+    m_progress_reporter{nullptr},
+    m_hashed_files_count{0}
+{}
+
+/**
+ * @brief Scans reference directories and indexes found files by size.
+ *
+ * @param dir_paths collection of paths to reference directories.
+ *
+ * @param exclude_dirs collection of paths to directories that must be excluded from the index.
+ *
+ * @param file_mask defines which file names would be indexed.
+ *
+ * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
+ */
+void ReferenceIndex::build(const std::vector<std::string>& dir_paths, const std::vector<std::string>& exclude_dirs,
+    const std::string& file_mask, bool is_recursive)
+{
+    m_paths = PathStore();
+    m_digests_by_size.clear();
+    m_hashed_files_count = 0;
+
+    DirectoryScanner scanner(dir_paths, exclude_dirs, m_min_file_size_bytes);
+    configure_scanner(scanner);
+    m_files_by_size = scanner.scan(m_paths, file_mask, is_recursive);
+}
+
+/**
+ * @brief Finds files of query directories, which are already present in the index.
+ *
+ * @param dir_paths collection of paths to query directories.
+ *
+ * @param exclude_dirs collection of paths to directories that must be excluded from the query.
+ *
+ * @param file_mask defines which file names would be queried.
+ *
+ * @param is_recursive indicicates directory scanning level. True - recursive scanning, False - only top level scanning.
+ *
+ * @return matched query files with their reference copies.
+ */
+ReferenceMatches ReferenceIndex::query(const std::vector<std::string>& dir_paths, const std::vector<std::string>& exclude_dirs,
+    const std::string& file_mask, bool is_recursive)
+{
+    PathStore query_paths;
+    DirectoryScanner scanner(dir_paths, exclude_dirs, m_min_file_size_bytes);
+    configure_scanner(scanner);
+    auto query_by_size = scanner.scan(query_paths, file_mask, is_recursive);
+
+    std::vector<PathStore::FileId> query_files;
+    std::vector<PathStore::FileId> references;
+    std::vector<size_t> reference_offsets { 0 };
+
+    for (const auto& [file_size, file_ids] : query_by_size)
+    {
+        // Query files of sizes, which are absent in the index, are never read.
+        if (!m_files_by_size.contains(file_size))
+        {
+            continue;
+        }
+
+        const auto& size_digests = get_size_digests(file_size);
+        for (const auto file_id : file_ids)
+        {
+            const auto digest = get_file_digest(query_paths.get_path(file_id), file_size);
+            auto [begin, end] = std::equal_range(size_digests.begin(), size_digests.end(), DigestEntry { digest, 0 },
+                [](const DigestEntry& left, const DigestEntry& right) { return digest_less(left.digest, right.digest); });
+            if (begin == end)
+            {
+                continue;
+            }
+
+            query_files.push_back(file_id);
+            for (auto it = begin; it != end; ++it)
+            {
+                references.push_back(it->file_id);
+            }
+            reference_offsets.push_back(references.size());
+        }
+    }
+
+    return { std::move(query_paths), std::move(query_files), std::move(references), std::move(reference_offsets) };
+}
+
+/**
+ * @brief Sets the way file blocks are read.
+ *
+ * @param block_reader block reader type.
+ */
+void ReferenceIndex::set_block_reader(BlockReaderType block_reader) noexcept
+{
+    m_block_reader = block_reader;
+}
+
+/**
+ * @brief Sets options of directory scanning. Memory lean scanning is off, since a query file of a unique size
+ * may still have reference copies. Archives are scanned as files, since their members can't be read as files.
+ *
+ * @param scan_options scan options.
+ */
+void ReferenceIndex::set_scan_options(const ScanOptions& scan_options) noexcept
+{
+    m_scan_options = scan_options;
+    m_scan_options.is_memory_lean = false;
+    m_scan_options.scan_archives = false;
+}
+
+/**
+ * @brief Sets token, which stops building and querying with @link OperationCanceledError @endlink, when canceled.
+ *
+ * @param cancellation_token cancellation token.
+ */
+void ReferenceIndex::set_cancellation_token(const CancellationToken& cancellation_token)
+{
+    m_cancellation_token = cancellation_token;
+}
+
+/**
+ * @brief Sets reporter of scanned files and hashed bytes.
+ *
+ * @param progress_reporter progress reporter, which outlives building and querying, or nullptr.
+ */
+void ReferenceIndex::set_progress_reporter(ProgressReporter* progress_reporter) noexcept
+{
+    m_progress_reporter = progress_reporter;
+}
+
+/**
+ * @brief Sets throttle of file reads and metadata operations of building and querying.
+ *
+ * @param throttle I/O throttle or nullptr.
+ */
+void ReferenceIndex::set_throttle(std::shared_ptr<IoThrottle> throttle) noexcept
+{
+    m_throttle = std::move(throttle);
+}
+
+/**
+ * @brief Gets path of the reference file.
+ *
+ * @param file_id reference file identifier.
+ */
+std::string ReferenceIndex::get_path(PathStore::FileId file_id) const
+{
+    return m_paths.get_path(file_id);
+}
+
+/**
+ * @brief Gets count of indexed reference files.
+ */
+size_t ReferenceIndex::files_count() const noexcept
+{
+    return m_paths.files_count();
+}
+
+/**
+ * @brief Gets count of reference files hashed so far.
+ */
+size_t ReferenceIndex::hashed_files_count() const noexcept
+{
+    return m_hashed_files_count;
+}
+
+void ReferenceIndex::configure_scanner(DirectoryScanner& scanner) const
+{
+    scanner.set_cancellation_token(m_cancellation_token);
+    scanner.set_progress_reporter(m_progress_reporter);
+    scanner.set_scan_options(m_scan_options);
+    scanner.set_throttle(m_throttle.get());
+}
+
+const std::vector<ReferenceIndex::DigestEntry>& ReferenceIndex::get_size_digests(size_t file_size)
+{
+    auto it = m_digests_by_size.find(file_size);
+    if (it != m_digests_by_size.end())
+    {
+        return it->second;
+    }
+
+    std::vector<DigestEntry> size_digests;
+    for (const auto file_id : m_files_by_size.at(file_size))
+    {
+        size_digests.push_back({ get_file_digest(m_paths.get_path(file_id), file_size), file_id });
+    }
+    m_hashed_files_count += size_digests.size();
+
+    std::sort(size_digests.begin(), size_digests.end(),
+        [](const DigestEntry& left, const DigestEntry& right) { return digest_less(left.digest, right.digest); });
+    return m_digests_by_size.emplace(file_size, std::move(size_digests)).first->second;
+}
+
+Digest ReferenceIndex::get_file_digest(const std::string& file_path, size_t file_size) const
+{
+    switch (m_hash_algorithm)
+    {
+        case HashAlgorithm::MD5:
+            return get_file_digest<Md5Hasher>(file_path, file_size);
+
+        default:
+            return get_file_digest<Crc32Hasher>(file_path, file_size);
+    }
+}
+
+template <typename THasher>
+Digest ReferenceIndex::get_file_digest(const std::string& file_path, size_t file_size) const
+{
+    switch (m_block_reader)
+    {
+        case BlockReaderType::Stream:
+            return compute_file_digest<THasher, StreamBlockReader>(file_path, m_block_size, file_size, m_throttle.get(),
+                m_cancellation_token, m_progress_reporter);
+
+        default:
+            return compute_file_digest<THasher, PosixBlockReader>(file_path, m_block_size, file_size, m_throttle.get(),
+                m_cancellation_token, m_progress_reporter);
+    }
+}
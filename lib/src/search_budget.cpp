@@ -0,0 +1,63 @@
+#include "../include/search_budget.h"
+
+using namespace bayan;
+
+/**
+ * @brief Creates instance of @link BudgetTracker::BudgetTracker @endlink and starts the clock.
+ *
+ * @param budget limits of the run.
+ */
+BudgetTracker::BudgetTracker(const SearchBudget& budget)
+    : m_budget{budget},
+    m_deadline{std::chrono::steady_clock::now() + budget.max_time},
+    m_bytes_read{0},
+    m_is_exhausted{false}
+{}
+
+/**
+ * @brief Accounts bytes, read from compared files.
+ *
+ * @param bytes_read count of read bytes.
+ */
+void BudgetTracker::add_bytes_read(std::uintmax_t bytes_read) noexcept
+{
+    m_bytes_read += bytes_read;
+}
+
+/**
+ * @brief Gets count of bytes, read from compared files.
+ */
+std::uintmax_t BudgetTracker::get_bytes_read() const noexcept
+{
+    return m_bytes_read;
+}
+
+/**
+ * @brief Checks whether any limit is reached. Once reached, the budget stays exhausted.
+ */
+bool BudgetTracker::is_exhausted() noexcept
+{
+    if (m_is_exhausted)
+    {
+        return true;
+    }
+
+    if (m_budget.max_bytes_read != 0 && m_bytes_read >= m_budget.max_bytes_read)
+    {
+        m_is_exhausted = true;
+    }
+    else if (m_budget.max_time.count() != 0 && std::chrono::steady_clock::now() >= m_deadline)
+    {
+        m_is_exhausted = true;
+    }
+
+    return m_is_exhausted;
+}
+
+/**
+ * @brief Gets time, when the time limit is reached, or the maximum time point, if there is no time limit.
+ */
+std::chrono::steady_clock::time_point BudgetTracker::get_deadline() const noexcept
+{
+    return m_budget.max_time.count() != 0 ? m_deadline : std::chrono::steady_clock::time_point::max();
+}
@@ -0,0 +1,87 @@
+#include "../include/search_progress.h"
+
+using namespace bayan;
+
+/**
+ * @brief Creates instance of @link ProgressReporter::ProgressReporter @endlink.
+ *
+ * @param callback progress callback.
+ *
+ * @param interval minimal interval between callback calls.
+ */
+ProgressReporter::ProgressReporter(ProgressCallback callback, std::chrono::milliseconds interval)
+    : m_callback{std::move(callback)},
+    m_interval{interval},
+    m_next_report{std::chrono::steady_clock::now() + interval}
+{}
+
+/**
+ * @brief Accounts visited regular files.
+ */
+void ProgressReporter::add_files_scanned(size_t count)
+{
+    m_progress.files_scanned += count;
+    report_if_due();
+}
+
+/**
+ * @brief Accounts read and hashed bytes.
+ */
+void ProgressReporter::add_bytes_hashed(std::uintmax_t count)
+{
+    m_progress.bytes_hashed += count;
+    report_if_due();
+}
+
+/**
+ * @brief Accounts resolved groups.
+ */
+void ProgressReporter::add_groups_resolved(size_t count)
+{
+    m_progress.groups_resolved += count;
+    report_if_due();
+}
+
+/**
+ * @brief Sets count of groups to resolve.
+ */
+void ProgressReporter::set_groups_total(size_t count)
+{
+    m_progress.groups_total = count;
+    report_if_due();
+}
+
+/**
+ * @brief Passes current progress to the callback regardless of the interval.
+ */
+void ProgressReporter::flush()
+{
+    if (m_callback)
+    {
+        m_callback(m_progress);
+        m_next_report = std::chrono::steady_clock::now() + m_interval;
+    }
+}
+
+/**
+ * @brief Gets current progress.
+ */
+const SearchProgress& ProgressReporter::get_progress() const noexcept
+{
+    return m_progress;
+}
+
+void ProgressReporter::report_if_due()
+{
+    if (!m_callback)
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now >= m_next_report)
+    {
+        m_callback(m_progress);
+        m_next_report = now + m_interval;
+    }
+}
@@ -0,0 +1,67 @@
+#include "../include/size_count_sketch.h"
+
+#include <stdexcept>
+
+using namespace bayan;
+
+/**
+ * @brief Creates instance of @link SizeCountSketch::SizeCountSketch @endlink.
+ *
+ * @param counters_count_log2 binary logarithm of count of counters in a row.
+ */
+SizeCountSketch::SizeCountSketch(size_t counters_count_log2)
+{
+    if (counters_count_log2 == 0 || counters_count_log2 > 32)
+    {
+        throw std::invalid_argument("Sketch size must be from 2 to 2^32 counters.");
+    }
+
+    m_mask = (std::uint64_t { 1 } << counters_count_log2) - 1;
+    m_counters.assign(rows_count * (m_mask + 1), 0);
+}
+
+/**
+ * @brief Counts one more file of the size.
+ *
+ * @param file_size size of file in bytes.
+ */
+void SizeCountSketch::add(std::uintmax_t file_size) noexcept
+{
+    for (size_t row = 0; row < rows_count; ++row)
+    {
+        auto& counter = m_counters[get_index(file_size, row)];
+        if (counter < 2)
+        {
+            ++counter;
+        }
+    }
+}
+
+/**
+ * @brief Checks whether files of the size may have been counted more than once.
+ *
+ * @param file_size size of file in bytes.
+ */
+bool SizeCountSketch::may_be_repeated(std::uintmax_t file_size) const noexcept
+{
+    for (size_t row = 0; row < rows_count; ++row)
+    {
+        if (m_counters[get_index(file_size, row)] < 2)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t SizeCountSketch::get_index(std::uintmax_t file_size, size_t row) const noexcept
+{
+    // Rows use independent multipliers of the 64-bit mixer, so sizes collide in them independently.
+    static constexpr std::uint64_t multipliers[rows_count] = { 0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full };
+
+    std::uint64_t hash = (static_cast<std::uint64_t>(file_size) + row) * multipliers[row];
+    hash ^= hash >> 29;
+    hash *= 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 32;
+    return row * (m_mask + 1) + (hash & m_mask);
+}
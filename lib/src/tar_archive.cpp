@@ -0,0 +1,344 @@
+#include "../include/tar_archive.h"
+
+#include <limits>
+#include <stdexcept>
+
+using namespace bayan;
+
+namespace
+{
+    constexpr size_t tar_block_size = 512;
+
+    // Long names and pax records are far smaller, so a larger extended header means a damaged archive.
+    constexpr std::uintmax_t max_extended_header_size = 1024 * 1024;
+
+    std::string_view get_field(const char* header, size_t offset, size_t size) noexcept
+    {
+        std::string_view field(header + offset, size);
+        return field.substr(0, field.find('\0'));
+    }
+
+    /**
+     * @brief Parses a numeric header field: octal digits or, for large values, base-256 with the high bit set.
+     */
+    bool try_parse_number(const char* header, size_t offset, size_t size, std::uintmax_t& value) noexcept
+    {
+        const auto* field = reinterpret_cast<const unsigned char*>(header + offset);
+        value = 0;
+        if ((field[0] & 0x80) != 0)
+        {
+            for (size_t i = 1; i < size; ++i)
+            {
+                value = (value << 8) | field[i];
+            }
+            return true;
+        }
+
+        size_t i = 0;
+        while (i < size && field[i] == ' ')
+        {
+            ++i;
+        }
+        for (; i < size && field[i] >= '0' && field[i] <= '7'; ++i)
+        {
+            value = (value << 3) | (field[i] - '0');
+        }
+        return i == size || field[i] == '\0' || field[i] == ' ';
+    }
+
+    bool is_valid_header(const char* header) noexcept
+    {
+        std::uintmax_t checksum = 0;
+        if (!try_parse_number(header, 148, 8, checksum))
+        {
+            return false;
+        }
+
+        // The checksum is computed with its own field filled with spaces.
+        std::uintmax_t sum = 0;
+        for (size_t i = 0; i < tar_block_size; ++i)
+        {
+            sum += i >= 148 && i < 156 ? ' ' : static_cast<unsigned char>(header[i]);
+        }
+        return sum == checksum;
+    }
+
+    std::uintmax_t get_padded_size(std::uintmax_t size) noexcept
+    {
+        return (size + tar_block_size - 1) / tar_block_size * tar_block_size;
+    }
+
+    /**
+     * @brief Gets the offset after member data, padded to whole blocks.
+     *
+     * @return false, if the offset overflows.
+     */
+    bool try_get_data_end(std::uintmax_t data_offset, std::uintmax_t size, std::uintmax_t& data_end) noexcept
+    {
+        constexpr auto max_offset = std::numeric_limits<std::uintmax_t>::max();
+        if (size > max_offset - tar_block_size || get_padded_size(size) > max_offset - data_offset)
+        {
+            return false;
+        }
+        data_end = data_offset + get_padded_size(size);
+        return true;
+    }
+
+    std::string normalize_name(std::string_view name)
+    {
+        while (name.starts_with("./") || name.starts_with('/'))
+        {
+            name.remove_prefix(name.starts_with('/') ? 1 : 2);
+        }
+        return std::string(name);
+    }
+
+    /**
+     * @brief Applies records of a pax extended header, e.g. '30 path=very/long/name\n'.
+     */
+    void apply_pax_records(std::string_view records, std::string& name, std::uintmax_t& size)
+    {
+        while (!records.empty())
+        {
+            const auto space = records.find(' ');
+            size_t length = 0;
+            if (space == std::string_view::npos)
+            {
+                return;
+            }
+            for (const auto digit : records.substr(0, space))
+            {
+                length = length * 10 + (digit - '0');
+            }
+            if (length <= space + 1 || length > records.size())
+            {
+                return;
+            }
+
+            const auto record = records.substr(space + 1, length - space - 2);
+            const auto separator = record.find('=');
+            if (separator != std::string_view::npos)
+            {
+                const auto key = record.substr(0, separator);
+                const auto value = record.substr(separator + 1);
+                if (key == "path")
+                {
+                    name = value;
+                }
+                else if (key == "size")
+                {
+                    size = 0;
+                    for (const auto digit : value)
+                    {
+                        size = size * 10 + (digit - '0');
+                    }
+                }
+            }
+            records.remove_prefix(length);
+        }
+    }
+}
+
+/**
+ * @brief Checks whether the file name is a name of an uncompressed tar archive.
+ *
+ * @param file_name file name.
+ */
+bool bayan::is_tar_archive(std::string_view file_name) noexcept
+{
+    return file_name.size() > 4 && file_name.ends_with(".tar");
+}
+
+/**
+ * @brief Reads regular file members of a tar archive from its headers. Member data isn't read.
+ * ustar, GNU long names and pax path and size records are supported. Reading stops at the first
+ * invalid header, so a file, which isn't a tar archive, has no members. It also stops at an extended header
+ * over 1 MiB or at a size, which overflows offsets.
+ *
+ * @param archive_path path to the archive.
+ *
+ * @param throttle throttle of header reads or nullptr.
+ *
+ * @param cancellation_token cancellation token.
+ *
+ * @return members in order of their offsets.
+ */
+std::vector<TarMember> bayan::read_tar_members(const std::string& archive_path, IoThrottle* throttle,
+    const CancellationToken& cancellation_token)
+{
+    TraceSpan span("io", "read_headers");
+    std::vector<TarMember> members;
+    PosixBlockReader reader(archive_path);
+    char header[tar_block_size];
+    std::uintmax_t offset = 0;
+
+    // Long names and pax records apply to the next header only.
+    std::string extended_name;
+    std::uintmax_t extended_size = 0;
+    bool has_extended_size = false;
+    std::string extended_data;
+
+    auto read = [&](char* data, size_t size)
+    {
+        if (throttle != nullptr)
+        {
+            throttle->acquire_read(size, cancellation_token);
+        }
+        return reader.read(data, size);
+    };
+
+    while (read(header, tar_block_size) == tar_block_size && is_valid_header(header))
+    {
+        // Sizes of damaged headers may overflow offsets, then reading stops.
+        const auto data_offset = offset + tar_block_size;
+        std::uintmax_t size = 0;
+        if (!try_parse_number(header, 124, 12, size) || !try_get_data_end(data_offset, size, offset))
+        {
+            break;
+        }
+
+        const auto type = header[156];
+        if (type == 'L' || type == 'x')
+        {
+            if (size > max_extended_header_size)
+            {
+                break;
+            }
+            extended_data.resize(static_cast<size_t>(get_padded_size(size)));
+            if (read(extended_data.data(), extended_data.size()) != extended_data.size())
+            {
+                break;
+            }
+            extended_data.resize(static_cast<size_t>(size));
+
+            if (type == 'L')
+            {
+                extended_name = extended_data.substr(0, extended_data.find('\0'));
+            }
+            else
+            {
+                std::uintmax_t pax_size = no_data_offset;
+                apply_pax_records(extended_data, extended_name, pax_size);
+                has_extended_size = pax_size != no_data_offset;
+                extended_size = has_extended_size ? pax_size : 0;
+            }
+            continue;
+        }
+
+        if (has_extended_size)
+        {
+            size = extended_size;
+            if (!try_get_data_end(data_offset, size, offset))
+            {
+                break;
+            }
+        }
+        reader.skip(offset - data_offset);
+
+        if (type == '0' || type == '\0' || type == '7')
+        {
+            std::string name = extended_name;
+            if (name.empty())
+            {
+                const auto prefix = get_field(header, 345, 155);
+                const auto short_name = get_field(header, 0, 100);
+                const bool is_ustar = get_field(header, 257, 6).starts_with("ustar");
+                name = is_ustar && !prefix.empty() ? std::string(prefix) + '/' + std::string(short_name) : std::string(short_name);
+            }
+
+            name = normalize_name(name);
+            if (!name.empty() && !name.ends_with('/'))
+            {
+                members.push_back({ std::move(name), data_offset, size });
+            }
+        }
+
+        extended_name.clear();
+        has_extended_size = false;
+    }
+
+    return members;
+}
+
+/**
+ * @brief Adds an archive.
+ *
+ * @param archive_path path to the archive.
+ *
+ * @return identifier of the archive.
+ */
+ArchiveMembers::ArchiveId ArchiveMembers::add_archive(const std::string& archive_path)
+{
+    m_archive_paths.push_back(archive_path);
+    return static_cast<ArchiveId>(m_archive_paths.size() - 1);
+}
+
+/**
+ * @brief Adds a member of the archive, which was stored as a file.
+ *
+ * @param file_id file identifier of the member.
+ *
+ * @param archive_id identifier of the archive.
+ *
+ * @param member member of the archive.
+ */
+void ArchiveMembers::add_member(PathStore::FileId file_id, ArchiveId archive_id, const TarMember& member)
+{
+    if (archive_id >= m_archive_paths.size())
+    {
+        throw std::invalid_argument("Archive is not added.");
+    }
+    m_locations[file_id] = { archive_id, member.offset, member.size, 0, 0 };
+}
+
+/**
+ * @brief Checks whether the file is an archive member.
+ *
+ * @param file_id file identifier.
+ */
+bool ArchiveMembers::contains(PathStore::FileId file_id) const
+{
+    return m_locations.contains(file_id);
+}
+
+/**
+ * @brief Checks whether there are no members.
+ */
+bool ArchiveMembers::empty() const noexcept
+{
+    return m_locations.empty();
+}
+
+/**
+ * @brief Gets file identifiers of all members.
+ *
+ * @return sorted file ids.
+ */
+std::vector<PathStore::FileId> ArchiveMembers::get_file_ids() const
+{
+    std::vector<PathStore::FileId> file_ids;
+    file_ids.reserve(m_locations.size());
+    for (const auto& [file_id, location] : m_locations)
+    {
+        file_ids.push_back(file_id);
+    }
+    std::sort(file_ids.begin(), file_ids.end());
+    return file_ids;
+}
+
+/**
+ * @brief Gets block digests of the member. A member, which fits into one block, has a single digest of its content.
+ *
+ * @param file_id file identifier of the member.
+ *
+ * @return digests, or an empty span, if the member isn't hashed.
+ */
+std::span<const hashing::Digest> ArchiveMembers::get_digests(PathStore::FileId file_id) const
+{
+    const auto location = m_locations.find(file_id);
+    if (location == m_locations.end())
+    {
+        return {};
+    }
+    return std::span(m_digests).subspan(location->second.digests_begin, location->second.digests_count);
+}
@@ -0,0 +1,112 @@
+#include "../include/throttle_control_file.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace bayan;
+
+/**
+ * @brief Creates instance of @link ThrottleControlFile::ThrottleControlFile @endlink and starts polling.
+ *
+ * @param file_path path to the control file. It may be created later.
+ *
+ * @param throttle throttle to be controlled.
+ *
+ * @param interval interval of polling.
+ */
+ThrottleControlFile::ThrottleControlFile(std::string file_path, std::shared_ptr<IoThrottle> throttle, std::chrono::milliseconds interval)
+    : m_file_path{std::move(file_path)},
+    m_throttle{std::move(throttle)},
+    m_interval{interval},
+    m_last_write_time{},
+    m_is_stop_requested{false}
+{
+    poll();
+    m_thread = std::thread([this]()
+    {
+        std::unique_lock lock(m_mutex);
+        while (!m_stop_condition.wait_for(lock, m_interval, [this]() { return m_is_stop_requested; }))
+        {
+            lock.unlock();
+            poll();
+            lock.lock();
+        }
+    });
+}
+
+/**
+ * @brief Stops polling.
+ */
+ThrottleControlFile::~ThrottleControlFile()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_is_stop_requested = true;
+    }
+    m_stop_condition.notify_one();
+    m_thread.join();
+}
+
+/**
+ * @brief Applies the control file, if it was changed since the last call.
+ *
+ * @return true, if limits were applied.
+ */
+bool ThrottleControlFile::poll()
+{
+    std::lock_guard lock(m_poll_mutex);
+
+    std::error_code error;
+    const auto write_time = std::filesystem::last_write_time(m_file_path, error);
+    if (error || write_time == m_last_write_time)
+    {
+        return false;
+    }
+
+    std::ifstream file(m_file_path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::stringstream content;
+    content << file.rdbuf();
+
+    auto limits = m_throttle->get_limits();
+    parse(content.str(), limits);
+    m_throttle->set_limits(limits);
+    m_last_write_time = write_time;
+    return true;
+}
+
+/**
+ * @brief Parses limits from control file content.
+ *
+ * @param content control file content.
+ *
+ * @param limits current limits, which are updated by present keys.
+ */
+void ThrottleControlFile::parse(const std::string& content, ThrottleLimits& limits)
+{
+    std::istringstream lines(content);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        const auto separator = line.find('=');
+        if (separator == std::string::npos)
+        {
+            continue;
+        }
+
+        const auto key = line.substr(0, separator);
+        std::uint64_t value = 0;
+        if (!(std::istringstream(line.substr(separator + 1)) >> value))
+        {
+            continue;
+        }
+
+        if (key == "bytes_per_second") { limits.bytes_per_second = value; }
+        else if (key == "reads_per_second") { limits.reads_per_second = value; }
+        else if (key == "metadata_ops_per_second") { limits.metadata_ops_per_second = value; }
+    }
+}
@@ -0,0 +1,247 @@
+#include "../include/tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace bayan;
+
+namespace
+{
+    constexpr std::uint64_t no_start = ~std::uint64_t { 0 };
+
+    struct TraceEvent
+    {
+        const char* category;
+        const char* name;
+        std::uint64_t start;
+        std::uint64_t duration;
+        std::uint64_t argument;
+    };
+
+    /**
+     * @brief Ring of the latest spans of one thread. It has a single writer.
+     */
+    class TraceRing final
+    {
+    public:
+        TraceRing(size_t capacity, std::uint32_t thread_id)
+            : m_events(capacity),
+            m_head{0},
+            m_thread_id{thread_id}
+        {}
+
+        void push(const TraceEvent& event) noexcept
+        {
+            const auto head = m_head.load(std::memory_order_relaxed);
+            m_events[head % m_events.size()] = event;
+            m_head.store(head + 1, std::memory_order_release);
+        }
+
+        template <typename TVisitor>
+        void for_each(TVisitor&& visitor) const
+        {
+            const auto head = m_head.load(std::memory_order_acquire);
+            const auto count = std::min<std::uint64_t>(head, m_events.size());
+            for (auto index = head - count; index < head; ++index)
+            {
+                visitor(m_events[index % m_events.size()]);
+            }
+        }
+
+        [[nodiscard]] std::uint32_t get_thread_id() const noexcept
+        {
+            return m_thread_id;
+        }
+
+    private:
+        std::vector<TraceEvent> m_events;
+        std::atomic<std::uint64_t> m_head;
+        std::uint32_t m_thread_id;
+    };
+
+    /**
+     * @brief Rings of all threads. Rings are shared, so they outlive their threads until export.
+     */
+    struct TraceRegistry
+    {
+        std::atomic<bool> is_enabled { false };
+        std::atomic<std::uint64_t> generation { 0 };
+        std::mutex mutex;
+        std::vector<std::shared_ptr<TraceRing>> rings;
+        size_t ring_capacity = 0;
+        std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    };
+
+    TraceRegistry& get_registry()
+    {
+        static TraceRegistry registry;
+        return registry;
+    }
+
+    std::uint64_t get_timestamp(const TraceRegistry& registry) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry.epoch).count();
+    }
+
+    TraceRing& get_thread_ring(TraceRegistry& registry)
+    {
+        thread_local std::shared_ptr<TraceRing> ring;
+        thread_local std::uint64_t ring_generation = 0;
+
+        const auto generation = registry.generation.load(std::memory_order_acquire);
+        if (!ring || ring_generation != generation)
+        {
+            std::lock_guard lock(registry.mutex);
+            ring = std::make_shared<TraceRing>(registry.ring_capacity, static_cast<std::uint32_t>(registry.rings.size() + 1));
+            registry.rings.push_back(ring);
+            ring_generation = generation;
+        }
+        return *ring;
+    }
+
+    void write_json_string(std::ostream& output, const char* value)
+    {
+        output << '"';
+        for (; *value != '\0'; ++value)
+        {
+            if (*value == '"' || *value == '\\')
+            {
+                output << '\\';
+            }
+            output << *value;
+        }
+        output << '"';
+    }
+}
+
+/**
+ * @brief Starts recording spans. Previously recorded spans are discarded.
+ *
+ * @param ring_capacity count of the latest spans, kept per thread.
+ */
+void Tracer::enable(size_t ring_capacity)
+{
+    if (ring_capacity == 0)
+    {
+        throw std::invalid_argument("Trace ring capacity must be positive.");
+    }
+
+    auto& registry = get_registry();
+    {
+        std::lock_guard lock(registry.mutex);
+        registry.rings.clear();
+        registry.ring_capacity = ring_capacity;
+        registry.epoch = std::chrono::steady_clock::now();
+        registry.generation.fetch_add(1, std::memory_order_release);
+    }
+    registry.is_enabled.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Stops recording spans. Recorded spans are kept for export.
+ */
+void Tracer::disable() noexcept
+{
+    get_registry().is_enabled.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Checks whether spans are recorded.
+ */
+bool Tracer::is_enabled() noexcept
+{
+    return get_registry().is_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Writes recorded spans in Chrome trace-event JSON format.
+ * Threads must not record spans during export.
+ *
+ * @param output destination stream.
+ */
+void Tracer::write_chrome_trace(std::ostream& output)
+{
+    auto& registry = get_registry();
+    std::lock_guard lock(registry.mutex);
+
+    output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool is_first = true;
+    for (const auto& ring : registry.rings)
+    {
+        ring->for_each([&output, &is_first, thread_id = ring->get_thread_id()](const TraceEvent& event)
+        {
+            output << (is_first ? "\n" : ",\n") << "{\"name\":";
+            write_json_string(output, event.name);
+            output << ",\"cat\":";
+            write_json_string(output, event.category);
+            output << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread_id
+                << ",\"ts\":" << event.start / 1000 << '.' << event.start % 1000 / 100 << event.start % 100 / 10 << event.start % 10
+                << ",\"dur\":" << event.duration / 1000 << '.' << event.duration % 1000 / 100 << event.duration % 100 / 10 << event.duration % 10
+                << ",\"args\":{\"value\":" << event.argument << "}}";
+            is_first = false;
+        });
+    }
+    output << "\n]}\n";
+}
+
+/**
+ * @brief Writes recorded spans in Chrome trace-event JSON format to the file.
+ *
+ * @param file_path path to the trace file.
+ */
+void Tracer::write_chrome_trace(const std::string& file_path)
+{
+    std::ofstream output(file_path);
+    if (!output.is_open())
+    {
+        throw std::runtime_error("Can't create trace file: '" + file_path + '\'');
+    }
+    write_chrome_trace(output);
+}
+
+/**
+ * @brief Starts the span.
+ *
+ * @param category span category. It must be a string literal.
+ *
+ * @param name span name. It must be a string literal.
+ *
+ * @param argument numeric argument of the span, e.g. a size.
+ */
+TraceSpan::TraceSpan(const char* category, const char* name, std::uint64_t argument) noexcept
+    : m_category{category},
+    m_name{name},
+    m_argument{argument},
+    m_start{Tracer::is_enabled() ? get_timestamp(get_registry()) : no_start}
+{}
+
+/**
+ * @brief Finishes the span.
+ */
+TraceSpan::~TraceSpan()
+{
+    if (m_start == no_start || !Tracer::is_enabled())
+    {
+        return;
+    }
+
+    auto& registry = get_registry();
+    const auto end = get_timestamp(registry);
+    get_thread_ring(registry).push({ m_category, m_name, m_start, end > m_start ? end - m_start : 0, m_argument });
+}
+
+/**
+ * @brief Sets numeric argument of the span, when it is known only at the end.
+ *
+ * @param argument numeric argument.
+ */
+void TraceSpan::set_argument(std::uint64_t argument) noexcept
+{
+    m_argument = argument;
+}
@@ -1,8 +1,16 @@
 #include <iostream>
+#include <memory>
+#include <optional>
 
 #include <boost/program_options.hpp>
 
+#include "chunk_analyzer.h"
+#include "deduplicator.h"
 #include "duplicate_files_searcher.h"
+#include "duplicate_index.h"
+#include "reference_index.h"
+#include "throttle_control_file.h"
+#include "tracing.h"
 
 int main(int argc, char** argv)
 {
@@ -12,26 +20,106 @@ int main(int argc, char** argv)
         ("help,H", "help message")
         ("dir,D", boost::program_options::value<std::vector<std::string>>(), "Target dir")
         ("exclude_dir,E", boost::program_options::value<std::vector<std::string>>(), "Exclude dir")
+        ("reference_dir", boost::program_options::value<std::vector<std::string>>(),
+            "Reference dir. If set, only files of target dirs, which are present in reference dirs, are reported")
         ("recursive,R", boost::program_options::value<bool>()->default_value(true), "Level of scan: 0 - top level only, 1 - recursive")
         ("min_file_size,F", boost::program_options::value<size_t>()->default_value(1), "Min file size in bytes")
         ("file_mask,M", boost::program_options::value<std::string>()->default_value(".*"), "File mask regex")
         ("block_size,S", boost::program_options::value<size_t>(), "Block size to read")
-        ("hash_algorithm,H", boost::program_options::value<size_t>()->default_value(0), "Hash algorithm");
+        ("hash_algorithm,H", boost::program_options::value<size_t>()->default_value(0), "Hash algorithm")
+        ("scheduling_policy", boost::program_options::value<size_t>()->default_value(0),
+            "Order of comparison: 0 - largest reclaimable bytes first, 1 - largest files first, 2 - smallest groups first, 3 - scan order")
+        ("memory_lean", boost::program_options::value<bool>()->default_value(false),
+            "Scan twice to keep paths only of files with repeated sizes")
+        ("follow_symlinks", boost::program_options::value<bool>()->default_value(false),
+            "Follow symbolic links, visiting each real directory and file once")
+        ("scan_archives", boost::program_options::value<bool>()->default_value(false),
+            "Search duplicates among members of '*.tar' archives too, reported as 'archive.tar!/member'")
+        ("walker", boost::program_options::value<size_t>()->default_value(0), "Directory walker: 0 - boost::filesystem, 1 - native getdents64")
+        ("block_reader", boost::program_options::value<size_t>()->default_value(0), "Block reader: 0 - POSIX, 1 - std::ifstream")
+        ("max_time", boost::program_options::value<size_t>()->default_value(0), "Max search time in seconds, 0 - unlimited")
+        ("max_bytes_read", boost::program_options::value<size_t>()->default_value(0), "Max bytes to read from compared files, 0 - unlimited")
+        ("max_bytes_per_second", boost::program_options::value<size_t>()->default_value(0), "Max bytes per second read from compared files, 0 - unlimited")
+        ("max_reads_per_second", boost::program_options::value<size_t>()->default_value(0), "Max reads per second from compared files, 0 - unlimited")
+        ("max_metadata_ops_per_second", boost::program_options::value<size_t>()->default_value(0),
+            "Max metadata operations per second during directory scanning, 0 - unlimited")
+        ("idle_io_priority", boost::program_options::value<bool>()->default_value(false), "Run with idle I/O scheduling class")
+        ("throttle_control_file", boost::program_options::value<std::string>(),
+            "File with 'key=value' lines of I/O limits, re-read while the search runs")
+        ("dedupe", boost::program_options::value<bool>()->default_value(false), "Share extents of found duplicates (btrfs, XFS)")
+        ("hardlink_fallback", boost::program_options::value<bool>()->default_value(false), "Replace duplicates with hard links, if extents can't be shared")
+        ("dry_run", boost::program_options::value<bool>()->default_value(false), "Only report what would be deduplicated")
+        ("trace", boost::program_options::value<std::string>(), "Write timeline of the run to the file in Chrome trace format")
+        ("index_file", boost::program_options::value<std::string>(), "Write found duplicates to the index file")
+        ("query_index", boost::program_options::value<std::string>(), "Query duplicates from the index file instead of searching")
+        ("query_path", boost::program_options::value<std::string>(), "Path of file to query duplicates of")
+        ("chunk_analysis", boost::program_options::value<bool>()->default_value(false),
+            "Report bytes shared by files at content-defined chunk level instead of searching whole duplicates")
+        ("chunk_size", boost::program_options::value<size_t>()->default_value(8192), "Average chunk size of chunk analysis")
+        ("query_size", boost::program_options::value<size_t>(), "Size of files to query duplicates of");
 
     boost::program_options::variables_map vm;
     boost::program_options::store(boost::program_options::parse_command_line(argc, argv, options), vm);
 
+    if (vm.count("query_index"))
+    {
+        try
+        {
+            bayan::DuplicateIndex index(vm["query_index"].as<std::string>());
+            auto print_group = [&index](bayan::DuplicateIndex::GroupId group_id)
+            {
+                for (const auto file_id : index.get_members(group_id))
+                {
+                    std::cout << index.get_paths().get_path(file_id) << std::endl;
+                }
+                std::cout << std::endl;
+            };
+
+            if (vm.count("query_path"))
+            {
+                auto group_id = index.find_by_path(vm["query_path"].as<std::string>());
+                if (group_id != bayan::DuplicateIndex::no_group)
+                {
+                    print_group(group_id);
+                }
+            }
+            else if (vm.count("query_size"))
+            {
+                auto [begin, end] = index.find_by_size(vm["query_size"].as<size_t>());
+                for (auto group_id = begin; group_id != end; ++group_id)
+                {
+                    print_group(group_id);
+                }
+            }
+            else
+            {
+                for (bayan::DuplicateIndex::GroupId group_id = 0; group_id < index.groups_count(); ++group_id)
+                {
+                    print_group(group_id);
+                }
+            }
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Bayan working process aborted: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
     if (!vm.count("dir"))
     {
         throw new std::runtime_error("'dir' is required");
     }
     auto dirs = vm["dir"].as<std::vector<std::string>>();
 
-    if (!vm.count("block_size"))
+    bool chunk_analysis = vm["chunk_analysis"].as<bool>();
+    if (!vm.count("block_size") && !chunk_analysis)
     {
         throw new std::runtime_error("'block_size' is required");
     }
-    auto block_size = vm["block_size"].as<size_t>();
+    auto block_size = vm.count("block_size") ? vm["block_size"].as<size_t>() : 0;
 
     bool recursive = vm["recursive"].as<bool>();
     size_t min_file_size = vm["min_file_size"].as<size_t>();
@@ -41,18 +129,177 @@ int main(int argc, char** argv)
         ? std::vector<std::string>()
         : vm["exclude_dir"].as<std::vector<std::string>>();
 
+    auto scheduling_policy = (bayan::SchedulingPolicy)vm["scheduling_policy"].as<size_t>();
+    bayan::SearchBudget budget;
+    budget.max_time = std::chrono::seconds(vm["max_time"].as<size_t>());
+    budget.max_bytes_read = vm["max_bytes_read"].as<size_t>();
+
+    bool dedupe = vm["dedupe"].as<bool>();
+    bayan::DeduplicationOptions deduplication_options;
+    deduplication_options.dry_run = vm["dry_run"].as<bool>();
+    deduplication_options.hardlink_fallback = vm["hardlink_fallback"].as<bool>();
+
+    bayan::ScanOptions scan_options;
+    scan_options.is_memory_lean = vm["memory_lean"].as<bool>();
+    scan_options.follow_symlinks = vm["follow_symlinks"].as<bool>();
+    scan_options.walker = (bayan::WalkerType)vm["walker"].as<size_t>();
+    scan_options.scan_archives = vm["scan_archives"].as<bool>();
+
+    // I/O limits and tracing apply to every mode.
+    bayan::ThrottleLimits throttle_limits;
+    throttle_limits.bytes_per_second = vm["max_bytes_per_second"].as<size_t>();
+    throttle_limits.reads_per_second = vm["max_reads_per_second"].as<size_t>();
+    throttle_limits.metadata_ops_per_second = vm["max_metadata_ops_per_second"].as<size_t>();
+    auto throttle = std::make_shared<bayan::IoThrottle>(throttle_limits);
+
+    if (vm["idle_io_priority"].as<bool>() && !bayan::set_idle_io_priority())
+    {
+        std::cerr << "Idle I/O priority is not supported" << std::endl;
+    }
+
+    std::optional<bayan::ThrottleControlFile> throttle_control_file;
+    if (vm.count("throttle_control_file"))
+    {
+        throttle_control_file.emplace(vm["throttle_control_file"].as<std::string>(), throttle);
+    }
+
+    if (vm.count("trace"))
+    {
+        bayan::Tracer::enable();
+    }
+    auto write_trace = [&vm]()
+    {
+        if (vm.count("trace"))
+        {
+            bayan::Tracer::disable();
+            bayan::Tracer::write_chrome_trace(vm["trace"].as<std::string>());
+        }
+    };
+
+    if (chunk_analysis)
+    {
+        try
+        {
+            bayan::ChunkingOptions chunking_options;
+            chunking_options.average_chunk_size = vm["chunk_size"].as<size_t>();
+            chunking_options.min_chunk_size = chunking_options.average_chunk_size / 4;
+            chunking_options.max_chunk_size = chunking_options.average_chunk_size * 8;
+
+            bayan::ChunkAnalyzer analyzer(chunking_options, min_file_size);
+            analyzer.set_scan_options(scan_options);
+            analyzer.set_throttle(throttle);
+
+            auto report = analyzer.analyze(dirs, exclude_dirs, file_mask, recursive);
+            write_trace();
+            for (const auto& pair : report.pairs)
+            {
+                std::cout << "Shared " << pair.shared_bytes << " bytes:" << std::endl
+                    << report.paths.get_path(pair.first) << std::endl
+                    << report.paths.get_path(pair.second) << std::endl << std::endl;
+            }
+
+            std::cout << "Total: " << report.total_bytes << " bytes in " << report.chunks_count << " chunks"
+                << ", unique: " << report.unique_bytes << " bytes in " << report.unique_chunks_count << " chunks"
+                << ", can be saved: " << report.total_bytes - report.unique_bytes << " bytes" << std::endl;
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Bayan working process aborted: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (vm.count("reference_dir"))
+    {
+        if (scan_options.scan_archives)
+        {
+            std::cerr << "'scan_archives' is not supported with 'reference_dir'" << std::endl;
+            return 1;
+        }
+
+        try
+        {
+            bayan::ReferenceIndex index(block_size, hash_algorithm, min_file_size);
+            index.set_block_reader((bayan::BlockReaderType)vm["block_reader"].as<size_t>());
+            index.set_scan_options(scan_options);
+            index.set_throttle(throttle);
+            index.build(vm["reference_dir"].as<std::vector<std::string>>(), exclude_dirs, file_mask, recursive);
+
+            auto matches = index.query(dirs, exclude_dirs, file_mask, recursive);
+            write_trace();
+            for (size_t i = 0; i < matches.size(); ++i)
+            {
+                std::cout << matches.get_query_path(i) << std::endl;
+                for (const auto file_id : matches.get_references(i))
+                {
+                    std::cout << index.get_path(file_id) << std::endl;
+                }
+                std::cout << std::endl;
+            }
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Bayan working process aborted: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
     bayan::DuplicateFilesSearcher searcher(block_size, hash_algorithm, min_file_size);
+    searcher.set_scheduling_policy(scheduling_policy);
+    searcher.set_budget(budget);
+    searcher.set_block_reader((bayan::BlockReaderType)vm["block_reader"].as<size_t>());
+    searcher.set_scan_options(scan_options);
+    searcher.set_throttle(throttle);
+
     try
     {
         auto duplicates = searcher.run(dirs, exclude_dirs, file_mask, recursive);
-        for (const auto& group : duplicates)
+        write_trace();
+
+        for (size_t i = 0; i < duplicates.size(); ++i)
         {
-            for (const auto& path : group)
+            for (const auto file_id : duplicates[i])
             {
-                std::cout << path << std::endl;
+                std::cout << duplicates.get_path(file_id) << std::endl;
             }
             std::cout << std::endl;
         }
+
+        if (!duplicates.is_complete())
+        {
+            std::cerr << "Search budget exhausted, unresolved groups of candidates: " << duplicates.unresolved_size() << std::endl;
+            for (size_t i = 0; i < duplicates.unresolved_size(); ++i)
+            {
+                for (const auto file_id : duplicates.get_unresolved(i))
+                {
+                    std::cerr << duplicates.get_path(file_id) << std::endl;
+                }
+                std::cerr << std::endl;
+            }
+        }
+
+        if (vm.count("index_file"))
+        {
+            bayan::DuplicateIndex::write(vm["index_file"].as<std::string>(), duplicates, hash_algorithm, block_size);
+        }
+
+        if (dedupe)
+        {
+            auto report = bayan::Deduplicator(deduplication_options).deduplicate(duplicates);
+            for (const auto& error : report.errors)
+            {
+                std::cerr << error << std::endl;
+            }
+
+            std::cout << (deduplication_options.dry_run ? "Can be deduplicated: " : "Deduplicated: ")
+                << report.files_deduplicated << " files, " << report.bytes_deduplicated << " bytes"
+                << " (cloned: " << report.files_cloned << ", linked: " << report.files_linked
+                << ", failed: " << report.files_failed << ")" << std::endl;
+        }
     }
     catch (std::exception& e)
     {
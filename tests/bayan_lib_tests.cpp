@@ -1,9 +1,30 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
 #include <unordered_map>
+#include <unordered_set>
 
+#include "chunk_analyzer.h"
+#include "comparable_file_content.h"
 #include "config.h"
+#include "deduplicator.h"
+#include "digest_group_table.h"
 #include "duplicate_files_searcher.h"
+#include "duplicate_index.h"
+#include "io_throttle.h"
+#include "reference_index.h"
+#include "tar_archive.h"
+#include "throttle_control_file.h"
+#include "tracing.h"
 
 template <class Collection1, class Collection2>
 bool collections_are_equivalent(Collection1 left, Collection2 right)
@@ -38,6 +59,53 @@ bool collections_are_equivalent(Collection1 left, Collection2 right)
     return true;
 }
 
+std::unordered_set<std::string> get_group_paths(const bayan::DuplicateGroups& duplicates, size_t index)
+{
+    std::unordered_set<std::string> paths;
+    for (const auto file_id : duplicates[index])
+    {
+        paths.insert(duplicates.get_path(file_id));
+    }
+    return paths;
+}
+
+// The directory is removed with its content at the end of the scope, even if an assertion fails.
+class TemporaryDirectory final
+{
+public:
+    TemporaryDirectory()
+        : m_path{boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()}
+    {
+        boost::filesystem::create_directories(m_path);
+    }
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+
+    ~TemporaryDirectory()
+    {
+        boost::system::error_code error;
+        boost::filesystem::remove_all(m_path, error);
+    }
+
+    TemporaryDirectory& operator =(const TemporaryDirectory&) = delete;
+
+    [[nodiscard]] const boost::filesystem::path& path() const noexcept { return m_path; }
+
+private:
+    boost::filesystem::path m_path;
+};
+
+size_t count_trace_events(const std::string& trace, const std::string& name)
+{
+    const auto pattern = "\"name\":\"" + name + "\"";
+    size_t count = 0;
+    for (auto position = trace.find(pattern); position != std::string::npos; position = trace.find(pattern, position + 1))
+    {
+        ++count;
+    }
+    return count;
+}
+
 // TODO: add gmock assertions
 TEST(Bayan, RecursiveTest) {
     std::string root = get_test_project_root();
@@ -56,11 +124,11 @@ TEST(Bayan, RecursiveTest) {
 
     std::vector<std::string> actual;
     actual.reserve(9);
-    for (const auto &set : duplicates)
+    for (size_t i = 0; i < duplicates.size(); ++i)
     {
-        for (const auto& path : set)
+        for (const auto file_id : duplicates[i])
         {
-            actual.push_back(std::move(path));
+            actual.push_back(duplicates.get_path(file_id));
         }
     }
 
@@ -95,9 +163,780 @@ TEST(Bayan, TopLevelTest) {
 
     EXPECT_EQ(duplicates.size(), 1);
 
-    EXPECT_EQ(duplicates[0],
+    EXPECT_EQ(get_group_paths(duplicates, 0),
       std::unordered_set<std::string>({
         root + "/dir/dir1/file1.1.txt",
         root + "/dir/dir1/afile1.2.txt",
       }));
 }
+
+TEST(Bayan, PathStoreTest) {
+    bayan::PathStore path_store;
+
+    auto root = path_store.add_directory(bayan::PathStore::no_directory, "/tmp/root/");
+    auto dir = path_store.add_directory(root, "dir");
+    auto file1 = path_store.add_file(dir, "file1.txt");
+    auto file2 = path_store.add_file(root, "file2.txt");
+
+    EXPECT_EQ(path_store.get_path(file1), "/tmp/root/dir/file1.txt");
+    EXPECT_EQ(path_store.get_path(file2), "/tmp/root/file2.txt");
+    EXPECT_EQ(path_store.get_directory_path(dir), "/tmp/root/dir");
+    EXPECT_EQ(path_store.get_name(file1), "file1.txt");
+    EXPECT_EQ(path_store.get_parent(file1), dir);
+    EXPECT_EQ(path_store.files_count(), 2);
+
+    EXPECT_THROW(path_store.add_file(dir + 1, "file3.txt"), std::invalid_argument);
+    EXPECT_THROW(path_store.add_directory(dir + 1, "dir2"), std::invalid_argument);
+    EXPECT_EQ(path_store.files_count(), 2);
+}
+
+TEST(Bayan, DigestGroupTableTest) {
+    bayan::DigestGroupTable table;
+    bayan::hashing::Md5Hasher md5;
+
+    auto first = md5("first");
+    auto second = md5("second");
+    for (bayan::PathStore::FileId file_id = 0; file_id < 100; ++file_id)
+    {
+        table.add(md5(std::to_string(file_id)), file_id);
+    }
+    table.add(first, 100);
+    table.add(second, 101);
+    table.add(first, 102);
+    table.add(second, 103);
+    table.add(first, 104);
+
+    EXPECT_EQ(table.groups_count(), 102);
+    EXPECT_EQ(table.group_size(table.find(first)), 3);
+    EXPECT_EQ(table.find(md5("missing")), bayan::DigestGroupTable::no_group);
+
+    std::vector<bayan::PathStore::FileId> members;
+    std::vector<size_t> offsets { 0 };
+    table.append_groups(members, offsets);
+
+    EXPECT_EQ(offsets, std::vector<size_t>({ 0, 3, 5 }));
+    EXPECT_EQ(members, std::vector<bayan::PathStore::FileId>({ 100, 102, 104, 101, 103 }));
+
+    table.clear();
+    EXPECT_EQ(table.groups_count(), 0);
+    EXPECT_EQ(table.find(first), bayan::DigestGroupTable::no_group);
+}
+
+TEST(Bayan, BudgetTest) {
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> dir_paths { root + "/dir" };
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+
+    bayan::SearchBudget budget;
+    budget.max_bytes_read = 1;
+
+    bayan::DuplicateFilesSearcher d(5, bayan::hashing::HashAlgorithm::MD5);
+    d.set_budget(budget);
+    auto duplicates = d.run(dir_paths, exclude_dirs, "*.*", true);
+
+    EXPECT_FALSE(duplicates.is_complete());
+    EXPECT_EQ(duplicates.size(), 0);
+    EXPECT_EQ(duplicates.unresolved_size(), 4);
+}
+
+TEST(Bayan, GroupSchedulerTest) {
+    bayan::DirectoryScanner::GroupedBySizeMap grouped_by_size
+    {
+        { 10, { 0, 1, 2, 3 } },
+        { 100, { 4, 5 } },
+        { 1000, { 6 } },
+        { 20, { 7, 8, 9, 10, 11, 12, 13 } },
+    };
+
+    auto tasks = bayan::GroupScheduler(bayan::SchedulingPolicy::LargestPayoffFirst).schedule(grouped_by_size);
+
+    ASSERT_EQ(tasks.size(), 3);
+    EXPECT_EQ(tasks[0].file_size, 20);
+    EXPECT_EQ(tasks[1].file_size, 100);
+    EXPECT_EQ(tasks[2].file_size, 10);
+    EXPECT_EQ(bayan::GroupScheduler::get_expected_payoff(tasks[0]), 120);
+}
+
+TEST(Bayan, DeduplicatorTest) {
+    TemporaryDirectory temp_directory;
+    const auto& temp_dir = temp_directory.path();
+    for (const auto* name : { "a.txt", "b.txt", "c.txt" })
+    {
+        std::ofstream(temp_dir / name) << "Hello, World\n";
+    }
+    std::ofstream(temp_dir / "d.txt") << "Hello, C++!!\n";
+
+    bayan::DuplicateFilesSearcher d(5, bayan::hashing::HashAlgorithm::MD5);
+    auto duplicates = d.run({ temp_dir.string() }, {}, "*.txt", false);
+    ASSERT_EQ(duplicates.size(), 1);
+
+    bayan::DeduplicationOptions options;
+    options.dry_run = true;
+    auto dry_run_report = bayan::Deduplicator(options).deduplicate(duplicates);
+    EXPECT_EQ(dry_run_report.files_deduplicated, 2);
+    EXPECT_EQ(dry_run_report.bytes_deduplicated, 26);
+    EXPECT_EQ(boost::filesystem::hard_link_count(temp_dir / "b.txt"), 1);
+
+    options.dry_run = false;
+    options.hardlink_fallback = true;
+    auto report = bayan::Deduplicator(options).deduplicate(duplicates);
+    EXPECT_EQ(report.files_deduplicated, 2);
+    EXPECT_EQ(report.files_failed, 0);
+    EXPECT_EQ(report.files_cloned + report.files_linked, 2);
+}
+
+TEST(Bayan, AsyncTest) {
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> dir_paths { root + "/dir" };
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+    bayan::DuplicateFilesSearcher d(5, bayan::hashing::HashAlgorithm::MD5);
+
+    bayan::SearchProgress last_progress;
+    bayan::AsyncSearchOptions options;
+    options.on_progress = [&last_progress](const bayan::SearchProgress& progress) { last_progress = progress; };
+
+    auto duplicates = d.run_async(options, dir_paths, exclude_dirs, "*.*", true).get();
+    EXPECT_EQ(duplicates.size(), 4);
+    EXPECT_EQ(last_progress.files_scanned, 10);
+    EXPECT_EQ(last_progress.groups_total, 4);
+    EXPECT_EQ(last_progress.groups_resolved, 4);
+    EXPECT_GT(last_progress.bytes_hashed, 0);
+
+    bayan::CancellationSource cancellation_source;
+    cancellation_source.cancel();
+    options.cancellation_token = cancellation_source.get_token();
+    options.executor = [](std::function<void()> task) { task(); };
+
+    auto canceled = d.run_async(options, dir_paths, exclude_dirs, "*.*", true);
+    EXPECT_THROW(canceled.get(), bayan::OperationCanceledError);
+}
+
+TEST(Bayan, EngineSpecializationTest) {
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> dir_paths { root + "/dir" };
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+
+    for (auto hash_algorithm : { bayan::hashing::HashAlgorithm::MD5, bayan::hashing::HashAlgorithm::CRС32 })
+    {
+        for (auto block_reader : { bayan::BlockReaderType::Posix, bayan::BlockReaderType::Stream })
+        {
+            bayan::DuplicateFilesSearcher d(5, hash_algorithm);
+            d.set_block_reader(block_reader);
+            auto duplicates = d.run(dir_paths, exclude_dirs, "*.*", true);
+
+            EXPECT_EQ(duplicates.size(), 4);
+        }
+    }
+}
+
+TEST(Bayan, BatchHashingTest) {
+    auto to_hex = [](const bayan::hashing::Digest& digest)
+    {
+        static const char* digits = "0123456789abcdef";
+        std::string result;
+        for (auto byte : digest.bytes)
+        {
+            result += digits[byte >> 4];
+            result += digits[byte & 0xf];
+        }
+        return result;
+    };
+
+    bayan::hashing::Md5Hasher md5;
+    EXPECT_EQ(to_hex(md5("")), "d41d8cd98f00b204e9800998ecf8427e");
+    EXPECT_EQ(to_hex(md5("abc")), "900150983cd24fb0d6963f7d28e17f72");
+    EXPECT_EQ(to_hex(md5("12345678901234567890123456789012345678901234567890123456789012345678901234567890")),
+        "57edf4a22be3c955ac49da2e2107b67a");
+
+    const size_t block_size = 100;
+    std::vector<std::string> blocks;
+    std::vector<const char*> block_pointers;
+    for (size_t i = 0; i < 37; ++i)
+    {
+        blocks.emplace_back(block_size, static_cast<char>('a' + i % 26));
+        blocks.back()[i] = '#';
+    }
+    for (const auto& block : blocks)
+    {
+        block_pointers.push_back(block.data());
+    }
+
+    std::vector<bayan::hashing::Digest> md5_digests(blocks.size());
+    md5(block_pointers, block_size, md5_digests);
+
+    bayan::hashing::Crc32Hasher crc32;
+    std::vector<bayan::hashing::Digest> crc32_digests(blocks.size());
+    crc32(block_pointers, block_size, crc32_digests);
+
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        EXPECT_EQ(md5_digests[i], md5(blocks[i]));
+        EXPECT_EQ(crc32_digests[i], crc32(blocks[i]));
+    }
+}
+
+TEST(Bayan, SmallFilesTest) {
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> dir_paths { root + "/dir" };
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+
+    auto get_groups = [&](size_t block_size)
+    {
+        bayan::DuplicateFilesSearcher d(block_size, bayan::hashing::HashAlgorithm::MD5);
+        auto duplicates = d.run(dir_paths, exclude_dirs, "*.*", true);
+
+        std::set<std::set<std::string>> groups;
+        for (size_t i = 0; i < duplicates.size(); ++i)
+        {
+            auto paths = get_group_paths(duplicates, i);
+            groups.emplace(paths.begin(), paths.end());
+        }
+        return groups;
+    };
+
+    // All files are read whole with the large block, and block by block with the small one.
+    const auto small_file_groups = get_groups(4096);
+    EXPECT_EQ(small_file_groups.size(), 4);
+    EXPECT_EQ(small_file_groups, get_groups(2));
+}
+
+TEST(Bayan, ReferenceIndexTest) {
+    std::string root = get_test_project_root();
+
+    TemporaryDirectory temp_directory;
+    const auto& temp_dir = temp_directory.path();
+    std::ofstream(temp_dir / "copy.txt") << "Hello, world!";
+    std::ofstream(temp_dir / "same_size.txt") << "Hello, World!";
+    std::ofstream(temp_dir / "other_size.txt") << "Hello";
+
+    bayan::ReferenceIndex index(5, bayan::hashing::HashAlgorithm::MD5);
+    index.build({ root + "/dir/dir1" }, {}, "*.*", true);
+    EXPECT_EQ(index.files_count(), 4);
+    EXPECT_EQ(index.hashed_files_count(), 0);
+
+    auto matches = index.query({ temp_dir.string() }, {}, "*.*", true);
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches.get_query_path(0), (temp_dir / "copy.txt").string());
+
+    std::unordered_set<std::string> references;
+    for (const auto file_id : matches.get_references(0))
+    {
+        references.insert(index.get_path(file_id));
+    }
+    EXPECT_EQ(references, (std::unordered_set<std::string> { root + "/dir/dir1/file1.1.txt", root + "/dir/dir1/afile1.2.txt" }));
+
+    // Only reference files of the queried size are hashed.
+    EXPECT_EQ(index.hashed_files_count(), 2);
+
+    bayan::ReferenceIndex stream_index(5, bayan::hashing::HashAlgorithm::MD5);
+    stream_index.set_block_reader(bayan::BlockReaderType::Stream);
+    stream_index.build({ root + "/dir/dir1" }, {}, "*.*", true);
+    EXPECT_EQ(stream_index.query({ temp_dir.string() }, {}, "*.*", true).size(), 1);
+
+    // A query file of a unique size is looked up in memory lean mode too.
+    boost::filesystem::create_directories(temp_dir / "single");
+    boost::filesystem::copy_file(temp_dir / "copy.txt", temp_dir / "single" / "copy.txt");
+    bayan::ScanOptions scan_options;
+    scan_options.is_memory_lean = true;
+    bayan::ProgressReporter progress;
+    bayan::ReferenceIndex lean_index(5, bayan::hashing::HashAlgorithm::MD5);
+    lean_index.set_scan_options(scan_options);
+    lean_index.set_progress_reporter(&progress);
+    lean_index.build({ root + "/dir/dir1" }, {}, "*.*", true);
+    EXPECT_EQ(lean_index.files_count(), 4);
+    EXPECT_EQ(lean_index.query({ (temp_dir / "single").string() }, {}, "*.*", true).size(), 1);
+    EXPECT_EQ(progress.get_progress().files_scanned, 5);
+
+    bayan::CancellationSource cancellation_source;
+    cancellation_source.cancel();
+    lean_index.set_cancellation_token(cancellation_source.get_token());
+    EXPECT_THROW(lean_index.query({ temp_dir.string() }, {}, "*.*", true), bayan::OperationCanceledError);
+}
+
+TEST(Bayan, DuplicateIndexTest) {
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> dir_paths { root + "/dir" };
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+
+    bayan::DuplicateFilesSearcher d(5, bayan::hashing::HashAlgorithm::MD5);
+    auto duplicates = d.run(dir_paths, exclude_dirs, "*.*", true);
+
+    TemporaryDirectory temp_directory;
+    auto index_path = temp_directory.path() / "index.bin";
+    bayan::DuplicateIndex::write(index_path.string(), duplicates, bayan::hashing::HashAlgorithm::MD5, 5);
+
+    bayan::DuplicateIndex index(index_path.string());
+    EXPECT_EQ(index.groups_count(), 4);
+    EXPECT_EQ(index.get_block_size(), 5);
+    EXPECT_EQ(index.get_paths().files_count(), 10);
+
+    auto [begin, end] = index.find_by_size(22);
+    ASSERT_EQ(end - begin, 1);
+    EXPECT_EQ(index.get_members(begin).size(), 3);
+    EXPECT_EQ(index.find_by_digest(22, index.get_group(begin).digest), begin);
+
+    auto group_id = index.find_by_path(root + "/dir/dir3/file3.1.txt");
+    ASSERT_NE(group_id, bayan::DuplicateIndex::no_group);
+    std::unordered_set<std::string> paths;
+    for (const auto file_id : index.get_members(group_id))
+    {
+        paths.insert(index.get_paths().get_path(file_id));
+    }
+    EXPECT_EQ(paths, (std::unordered_set<std::string> { root + "/dir/dir3/file3.1.txt", root + "/dir/dir3/file3.2.txt" }));
+
+    EXPECT_EQ(index.find_by_path(root + "/dir/file.txt"), bayan::DuplicateIndex::no_group);
+    EXPECT_EQ(index.find_by_path(root + "/dir/missing.txt"), bayan::DuplicateIndex::no_group);
+}
+
+TEST(Bayan, MemoryLeanScanTest) {
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> dir_paths { root + "/dir" };
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+
+    bayan::PathStore path_store;
+    bayan::DirectoryScanner scanner(dir_paths, exclude_dirs);
+    auto groups = scanner.scan(path_store, "*.*", true);
+    EXPECT_EQ(path_store.files_count(), 10);
+
+    bayan::ScanOptions options;
+    options.is_memory_lean = true;
+    options.sketch_size_log2 = 10;
+
+    bayan::PathStore lean_path_store;
+    scanner.set_scan_options(options);
+    auto lean_groups = scanner.scan(lean_path_store, "*.*", true);
+
+    // The only file of unique size is not stored.
+    EXPECT_EQ(lean_path_store.files_count(), 9);
+    EXPECT_EQ(lean_groups.size(), 4);
+    for (const auto& [size, file_ids] : lean_groups)
+    {
+        EXPECT_EQ(file_ids.size(), groups.at(size).size());
+    }
+
+    bayan::DuplicateFilesSearcher d(5, bayan::hashing::HashAlgorithm::MD5);
+    d.set_scan_options(options);
+    EXPECT_EQ(d.run(dir_paths, exclude_dirs, "*.*", true).size(), 4);
+}
+
+TEST(Bayan, FollowSymlinksTest) {
+    TemporaryDirectory temp_directory;
+    const auto& temp_dir = temp_directory.path();
+    boost::filesystem::create_directories(temp_dir / "a");
+    boost::filesystem::create_directories(temp_dir / "c");
+    std::ofstream(temp_dir / "a" / "file1.txt") << "Hello, World\n";
+    std::ofstream(temp_dir / "a" / "file2.txt") << "Hello, World\n";
+    boost::filesystem::create_directory_symlink(temp_dir / "a", temp_dir / "b");
+    boost::filesystem::create_directory_symlink(temp_dir, temp_dir / "c" / "loop");
+    boost::filesystem::create_symlink(temp_dir / "a" / "file1.txt", temp_dir / "c" / "link.txt");
+
+    bayan::ScanOptions options;
+    options.follow_symlinks = true;
+
+    // Both links to directories and the link to the file lead to already visited targets.
+    for (auto walker : { bayan::WalkerType::Boost, bayan::WalkerType::Native })
+    {
+        options.walker = walker;
+
+        bayan::PathStore path_store;
+        bayan::DirectoryScanner scanner({ temp_dir.string() }, {});
+        scanner.set_scan_options(options);
+        auto groups = scanner.scan(path_store, "*.*", true);
+        EXPECT_EQ(path_store.files_count(), 2);
+        ASSERT_EQ(groups.size(), 1);
+        EXPECT_EQ(groups.begin()->second.size(), 2);
+    }
+
+    bayan::DuplicateFilesSearcher d(5, bayan::hashing::HashAlgorithm::MD5);
+    d.set_scan_options(options);
+    auto duplicates = d.run({ temp_dir.string() }, {}, "*.*", true);
+    ASSERT_EQ(duplicates.size(), 1);
+    EXPECT_EQ(duplicates[0].size(), 2);
+}
+
+TEST(Bayan, NativeWalkerTest) {
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> dir_paths { root + "/dir" };
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+
+    auto get_paths_by_size = [&](bayan::WalkerType walker, bool is_recursive)
+    {
+        bayan::ScanOptions options;
+        options.walker = walker;
+
+        bayan::PathStore path_store;
+        bayan::DirectoryScanner scanner(dir_paths, exclude_dirs);
+        scanner.set_scan_options(options);
+
+        std::map<size_t, std::set<std::string>> paths_by_size;
+        for (const auto& [size, file_ids] : scanner.scan(path_store, "*.*", is_recursive))
+        {
+            for (const auto file_id : file_ids)
+            {
+                paths_by_size[size].insert(path_store.get_path(file_id));
+            }
+        }
+        return paths_by_size;
+    };
+
+    for (bool is_recursive : { true, false })
+    {
+        const auto native_paths = get_paths_by_size(bayan::WalkerType::Native, is_recursive);
+        EXPECT_EQ(native_paths, get_paths_by_size(bayan::WalkerType::Boost, is_recursive));
+        EXPECT_EQ(native_paths.size(), is_recursive ? 5 : 1);
+    }
+}
+
+TEST(Bayan, OverlappingRootsTest) {
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+
+    auto get_paths = [&](const std::vector<std::string>& dir_paths, bayan::WalkerType walker)
+    {
+        bayan::ScanOptions options;
+        options.walker = walker;
+
+        bayan::PathStore path_store;
+        bayan::DirectoryScanner scanner(dir_paths, exclude_dirs);
+        scanner.set_scan_options(options);
+
+        std::vector<std::string> paths;
+        for (const auto& [size, file_ids] : scanner.scan(path_store, "*.*", true))
+        {
+            for (const auto file_id : file_ids)
+            {
+                paths.push_back(path_store.get_path(file_id));
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    };
+
+    for (auto walker : { bayan::WalkerType::Boost, bayan::WalkerType::Native })
+    {
+        const auto expected = get_paths({ root + "/dir" }, walker);
+
+        // Repeated roots and roots inside other roots are scanned once.
+        EXPECT_EQ(get_paths({ root + "/dir", root + "/dir" }, walker), expected);
+        EXPECT_EQ(get_paths({ root + "/dir", root + "/dir/dir1" }, walker), expected);
+        EXPECT_EQ(get_paths({ root + "/dir/dir1", root + "/dir/" }, walker), expected);
+
+        // A root inside an excluded directory is still scanned.
+        const auto paths = get_paths({ root + "/dir", root + "/dir/dir_to_exclude" }, walker);
+        EXPECT_GT(paths.size(), expected.size());
+        EXPECT_EQ(std::adjacent_find(paths.begin(), paths.end()), paths.end());
+    }
+
+    bayan::DuplicateFilesSearcher d(5, bayan::hashing::HashAlgorithm::MD5);
+    auto duplicates = d.run({ root + "/dir", root + "/dir/dir1" }, exclude_dirs, "*.*", true);
+    EXPECT_EQ(duplicates.size(), 4);
+}
+
+TEST(Bayan, TracingTest) {
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> dir_paths { root + "/dir" };
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+
+    bayan::DuplicateFilesSearcher d(5, bayan::hashing::HashAlgorithm::MD5);
+
+    bayan::Tracer::enable();
+    d.run(dir_paths, exclude_dirs, "*.*", true);
+    bayan::Tracer::disable();
+
+    // Spans, finished after tracing is disabled, are not recorded.
+    d.run(dir_paths, exclude_dirs, "*.*", true);
+
+    std::ostringstream trace;
+    bayan::Tracer::write_chrome_trace(trace);
+
+    EXPECT_EQ(trace.str().rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0);
+    EXPECT_EQ(count_trace_events(trace.str(), "search"), 1);
+    EXPECT_EQ(count_trace_events(trace.str(), "group"), 4);
+    EXPECT_GT(count_trace_events(trace.str(), "read_block"), 0);
+    EXPECT_GT(count_trace_events(trace.str(), "hash_batch"), 0);
+}
+
+TEST(Bayan, ThrottleTest) {
+    // A full bucket grants a second of tokens and a larger request leaves a debt, which the next request waits for.
+    bayan::RateLimiter limiter(1000);
+    const auto start = std::chrono::steady_clock::now();
+    limiter.acquire(1000);
+    limiter.acquire(500);
+    limiter.acquire(1);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(400));
+
+    // Waits end at the deadline and stop, when canceled.
+    bayan::RateLimiter slow_limiter(1);
+    slow_limiter.acquire(100);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+    slow_limiter.acquire(1, {}, deadline);
+    EXPECT_LT(std::chrono::steady_clock::now() - deadline, std::chrono::seconds(1));
+    bayan::CancellationSource cancellation_source;
+    cancellation_source.cancel();
+    EXPECT_THROW(slow_limiter.acquire(1, cancellation_source.get_token()), bayan::OperationCanceledError);
+
+    bayan::ThrottleLimits limits;
+    limits.reads_per_second = 7;
+    bayan::ThrottleControlFile::parse("bytes_per_second=1048576\nunknown=1\nmetadata_ops_per_second=abc\n", limits);
+    EXPECT_EQ(limits.bytes_per_second, 1048576);
+    EXPECT_EQ(limits.reads_per_second, 7);
+    EXPECT_EQ(limits.metadata_ops_per_second, 0);
+
+    std::string root = get_test_project_root();
+
+    std::vector<std::string> dir_paths { root + "/dir" };
+    std::vector<std::string> exclude_dirs { root + "/dir/dir_to_exclude" };
+
+    bayan::DuplicateFilesSearcher d(5, bayan::hashing::HashAlgorithm::MD5);
+    d.set_throttle(std::make_shared<bayan::IoThrottle>(bayan::ThrottleLimits { 1024 * 1024, 10000, 10000 }));
+    for (const auto walker : { bayan::WalkerType::Boost, bayan::WalkerType::Native })
+    {
+        bayan::ScanOptions scan_options;
+        scan_options.walker = walker;
+        d.set_scan_options(scan_options);
+        EXPECT_EQ(d.run(dir_paths, exclude_dirs, "*.*", true).size(), 4);
+    }
+
+    // A time budget isn't overrun by waiting for a throttle.
+    bayan::SearchBudget budget;
+    budget.max_time = std::chrono::milliseconds(100);
+    d.set_budget(budget);
+    d.set_throttle(std::make_shared<bayan::IoThrottle>(bayan::ThrottleLimits { 0, 1, 0 }));
+    const auto search_start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(d.run(dir_paths, exclude_dirs, "*.*", true).is_complete());
+    EXPECT_LT(std::chrono::steady_clock::now() - search_start, std::chrono::seconds(2));
+}
+
+TEST(Bayan, SparseFilesTest) {
+    TemporaryDirectory temp_directory;
+    const auto& temp_dir = temp_directory.path();
+
+    constexpr size_t file_size = 1024 * 1024;
+    constexpr size_t block_size = 4096;
+    auto write_file = [&temp_dir](const std::string& name, const std::string& data, bool is_sparse)
+    {
+        std::ofstream file(temp_dir / name, std::ios::binary);
+        if (!is_sparse)
+        {
+            file << std::string(file_size / 2, '\0');
+        }
+        file.seekp(file_size / 2);
+        file << data;
+        file.close();
+        boost::filesystem::resize_file(temp_dir / name, file_size);
+    };
+    write_file("sparse.img", "data", true);
+    write_file("dense.img", "data", false);
+    write_file("other.img", "datb", true);
+
+    // Holes are skipped without reading, where the file system supports them, and read as zeros otherwise.
+    bayan::ComparableFileContent<> file_content((temp_dir / "sparse.img").string(), block_size);
+    std::string block(block_size, '\0');
+    for (size_t offset = 0; offset < file_size; offset += block_size)
+    {
+        file_content.read_next_block(block.data());
+        EXPECT_EQ(block.find_first_not_of('\0') == std::string::npos, offset != file_size / 2);
+    }
+    struct stat sparse_stat {};
+    ASSERT_EQ(::stat((temp_dir / "sparse.img").c_str(), &sparse_stat), 0);
+    if (static_cast<size_t>(sparse_stat.st_blocks) * 512 < file_size)
+    {
+        EXPECT_LT(file_content.get_bytes_read(), file_size / 2);
+    }
+
+    // Same content of different data/hole layouts is equal.
+    bayan::DuplicateFilesSearcher d(block_size, bayan::hashing::HashAlgorithm::MD5);
+    auto duplicates = d.run({ temp_dir.string() }, {}, "*.*", true);
+    ASSERT_EQ(duplicates.size(), 1);
+    EXPECT_TRUE(collections_are_equivalent(get_group_paths(duplicates, 0),
+        std::vector<std::string> { (temp_dir / "sparse.img").string(), (temp_dir / "dense.img").string() }));
+}
+
+TEST(Bayan, ChunkAnalysisTest) {
+    bayan::ContentChunker chunker;
+    const bayan::ChunkingOptions options;
+    std::mt19937 random(42);
+    std::string content(1024 * 1024, '\0');
+    for (auto& byte : content)
+    {
+        byte = static_cast<char>(random());
+    }
+
+    // Cuts are bounded by chunk sizes and a tail shorter than the minimum is one chunk.
+    for (size_t begin = 0; begin < content.size();)
+    {
+        const auto size = chunker.find_cut(content.data() + begin, content.size() - begin);
+        EXPECT_LE(size, options.max_chunk_size);
+        EXPECT_TRUE(size >= options.min_chunk_size || begin + size == content.size());
+        begin += size;
+    }
+
+    TemporaryDirectory temp_directory;
+    const auto& temp_dir = temp_directory.path();
+    std::ofstream(temp_dir / "original.bin", std::ios::binary) << content;
+    std::ofstream(temp_dir / "appended.bin", std::ios::binary) << content << std::string(50000, 'a');
+    std::ofstream(temp_dir / "inserted.bin", std::ios::binary) << std::string(10000, 'i') << content;
+    std::ofstream(temp_dir / "unrelated.bin", std::ios::binary) << std::string(content.rbegin(), content.rend());
+
+    // Chunks after an insertion are aligned again, so files of different sizes share almost all content.
+    auto report = bayan::ChunkAnalyzer().analyze({ temp_dir.string() }, {}, "*.*", true);
+    EXPECT_EQ(report.total_bytes, 4 * content.size() + 60000);
+    EXPECT_EQ(report.pairs.size(), 3);
+    for (const auto& pair : report.pairs)
+    {
+        EXPECT_GT(pair.shared_bytes, content.size() - 2 * options.max_chunk_size);
+        EXPECT_EQ(report.paths.get_path(pair.first).find("unrelated"), std::string::npos);
+        EXPECT_EQ(report.paths.get_path(pair.second).find("unrelated"), std::string::npos);
+    }
+    EXPECT_LT(report.unique_bytes, 2 * content.size() + 60000 + 2 * options.max_chunk_size);
+
+    // Files of unique sizes are analyzed in memory lean mode too.
+    bayan::ScanOptions scan_options;
+    scan_options.is_memory_lean = true;
+    bayan::ChunkAnalyzer lean_analyzer;
+    lean_analyzer.set_scan_options(scan_options);
+    const auto lean_report = lean_analyzer.analyze({ temp_dir.string() }, {}, "*.*", true);
+    EXPECT_EQ(lean_report.total_bytes, report.total_bytes);
+    EXPECT_EQ(lean_report.pairs.size(), 3);
+
+    // Scanning and reads report progress and stop, when canceled.
+    bayan::ProgressReporter progress;
+    bayan::ChunkAnalyzer analyzer;
+    analyzer.set_progress_reporter(&progress);
+    analyzer.analyze({ temp_dir.string() }, {}, "*.*", true);
+    EXPECT_EQ(progress.get_progress().files_scanned, 4);
+    EXPECT_EQ(progress.get_progress().bytes_hashed, report.total_bytes);
+
+    bayan::CancellationSource cancellation_source;
+    cancellation_source.cancel();
+    analyzer.set_cancellation_token(cancellation_source.get_token());
+    EXPECT_THROW(analyzer.analyze({ temp_dir.string() }, {}, "*.*", true), bayan::OperationCanceledError);
+}
+
+TEST(Bayan, TarArchiveTest) {
+    TemporaryDirectory temp_directory;
+    const auto& temp_dir = temp_directory.path();
+
+    // A size of more than 11 octal digits is written in base-256.
+    auto write_header = [](std::ostream& archive, const std::string& name, std::uint64_t size, char type)
+    {
+        char header[512] {};
+        std::snprintf(header, 100, "%s", name.c_str());
+        std::snprintf(header + 100, 8, "%07o", 0644);
+        if (size < (std::uint64_t { 1 } << 33))
+        {
+            std::snprintf(header + 124, 12, "%011llo", static_cast<unsigned long long>(size));
+        }
+        else
+        {
+            header[124] = static_cast<char>(0x80);
+            for (size_t i = 0; i < 8; ++i)
+            {
+                header[135 - i] = static_cast<char>(size >> (8 * i));
+            }
+        }
+        header[156] = type;
+        std::memcpy(header + 257, "ustar", 6);
+        std::memcpy(header + 263, "00", 2);
+        std::memset(header + 148, ' ', 8);
+        unsigned checksum = 0;
+        for (const auto byte : header)
+        {
+            checksum += static_cast<unsigned char>(byte);
+        }
+        std::snprintf(header + 148, 8, "%06o", checksum);
+        archive.write(header, sizeof(header));
+    };
+    auto write_member = [&write_header](std::ostream& archive, const std::string& name, const std::string& content)
+    {
+        write_header(archive, name, content.size(), '0');
+        archive << content << std::string((512 - content.size() % 512) % 512, '\0');
+    };
+
+    const std::string small(100, 's');
+    const std::string large = std::string(3000, 'l') + 'x';
+    {
+        std::ofstream archive(temp_dir / "backup.tar", std::ios::binary);
+        write_member(archive, "./docs/small.txt", small);
+        write_member(archive, "docs/large.txt", large);
+        write_member(archive, "other.txt", std::string(3000, 'l') + 'y');
+        archive << std::string(1024, '\0');
+    }
+    std::ofstream(temp_dir / "small.txt", std::ios::binary) << small;
+    std::ofstream(temp_dir / "large.txt", std::ios::binary) << large;
+
+    auto members = bayan::read_tar_members((temp_dir / "backup.tar").string());
+    ASSERT_EQ(members.size(), 3);
+    EXPECT_EQ(members[0].name, "docs/small.txt");
+    EXPECT_EQ(members[1].offset, 1536);
+    EXPECT_EQ(members[1].size, large.size());
+
+    // Reading stops at an oversized extended header or a size, which overflows offsets.
+    for (const auto size : { std::uint64_t { 2 } << 20, ~std::uint64_t { 0 } })
+    {
+        {
+            std::ofstream archive(temp_dir / "damaged.tar", std::ios::binary);
+            write_member(archive, "small.txt", small);
+            write_header(archive, "PaxHeaders/large.txt", size, 'x');
+            write_member(archive, "large.txt", large);
+        }
+        EXPECT_EQ(bayan::read_tar_members((temp_dir / "damaged.tar").string()).size(), 1);
+    }
+    boost::filesystem::remove(temp_dir / "damaged.tar");
+
+    // Members are compared with loose files of any block size relation.
+    // Member data is read in one pass over the archive, after its headers are scanned once, even by a memory lean scan.
+    const auto archive_path = (temp_dir / "backup.tar!").string();
+    bayan::ScanOptions options;
+    options.scan_archives = true;
+    for (auto [walker, is_memory_lean] : { std::pair { bayan::WalkerType::Boost, false }, std::pair { bayan::WalkerType::Native, false },
+        std::pair { bayan::WalkerType::Native, true } })
+    {
+        options.walker = walker;
+        options.is_memory_lean = is_memory_lean;
+        bayan::DuplicateFilesSearcher d(1024, bayan::hashing::HashAlgorithm::MD5);
+        d.set_scan_options(options);
+
+        bayan::Tracer::enable();
+        auto duplicates = d.run({ temp_dir.string() }, {}, "*.txt", true);
+        bayan::Tracer::disable();
+        std::ostringstream trace;
+        bayan::Tracer::write_chrome_trace(trace);
+        EXPECT_EQ(count_trace_events(trace.str(), "read_archive"), 1);
+        EXPECT_EQ(count_trace_events(trace.str(), "read_headers"), 1);
+
+        ASSERT_EQ(duplicates.size(), 2);
+
+        const std::unordered_set<std::string> small_group { archive_path + "/docs/small.txt", (temp_dir / "small.txt").string() };
+        const std::unordered_set<std::string> large_group { archive_path + "/docs/large.txt", (temp_dir / "large.txt").string() };
+        const auto first_group = get_group_paths(duplicates, 0);
+        EXPECT_TRUE(first_group == small_group ? get_group_paths(duplicates, 1) == large_group : first_group == large_group);
+    }
+
+    // Archive members are neither sources nor destinations of deduplication.
+    std::ofstream(temp_dir / "large copy.txt", std::ios::binary) << large;
+    bayan::DuplicateFilesSearcher d(1024, bayan::hashing::HashAlgorithm::MD5);
+    d.set_scan_options(options);
+    auto duplicates = d.run({ temp_dir.string() }, {}, "*.txt", true);
+    ASSERT_EQ(duplicates.size(), 2);
+    bayan::DeduplicationOptions dedupe_options;
+    dedupe_options.hardlink_fallback = true;
+    for (auto dry_run : { true, false })
+    {
+        dedupe_options.dry_run = dry_run;
+        auto report = bayan::Deduplicator(dedupe_options).deduplicate(duplicates);
+        EXPECT_TRUE(report.errors.empty());
+        EXPECT_EQ(report.files_failed, 0);
+        EXPECT_EQ(report.files_deduplicated, 1);
+        EXPECT_EQ(report.bytes_deduplicated, large.size());
+    }
+}